@@ -0,0 +1,35 @@
+#include "Stats.hpp"
+#include <cstdlib>
+#include <new>
+
+#if defined(LAB_STATS)
+// Замена глобального operator new считает выделения памяти. new[] и nothrow-версии
+// стандартной библиотеки вызывают его же, а выделенное через malloc освобождает free
+void* operator new(std::size_t size)
+{
+	CountAllocation(size);
+	while (true)
+	{
+		if (void* memory = std::malloc(size != 0 ? size : 1))
+		{
+			return memory;
+		}
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+#endif
@@ -0,0 +1,129 @@
+#include "BufferedIO.hpp"
+#include <cstring>
+
+BufferedReader::BufferedReader(std::istream& in, size_t blockSize)
+	: m_in(in)
+	, m_buffer(blockSize)
+{
+}
+
+std::span<char> BufferedReader::ReadBlock()
+{
+	if (m_pos == m_size && !Fill())
+	{
+		return {};
+	}
+	std::span<char> block(m_buffer.data() + m_pos, m_size - m_pos);
+	m_pos = m_size;
+	return block;
+}
+
+bool BufferedReader::ReadLine(std::string& line)
+{
+	line.clear();
+	if (m_pos == m_size && !Fill())
+	{
+		return false;
+	}
+	do
+	{
+		const char* begin = m_buffer.data() + m_pos;
+		const void* found = std::memchr(begin, '\n', m_size - m_pos);
+		if (found != nullptr)
+		{
+			const char* end = static_cast<const char*>(found);
+			line.append(begin, end);
+			m_pos += end - begin + 1;
+			return true;
+		}
+		line.append(begin, m_size - m_pos);
+		m_pos = m_size;
+	} while (Fill());
+	return true;
+}
+
+bool BufferedReader::Fill()
+{
+	m_in.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+	m_pos = 0;
+	m_size = static_cast<size_t>(m_in.gcount());
+	return m_size != 0;
+}
+
+std::vector<char> ReadAll(std::istream& in)
+{
+	std::vector<char> text;
+	while (in)
+	{
+		size_t size = text.size();
+		text.resize(size + IO_BLOCK_SIZE);
+		in.read(text.data() + size, IO_BLOCK_SIZE);
+		text.resize(size + static_cast<size_t>(in.gcount()));
+	}
+	return text;
+}
+
+BufferedWriter::BufferedWriter(std::ostream& out, size_t bufferSize)
+	: m_out(out)
+	, m_buffer(bufferSize)
+{
+}
+
+BufferedWriter::~BufferedWriter()
+{
+	WriteBuffer();
+}
+
+void BufferedWriter::Write(std::string_view text)
+{
+	if (m_buffer.size() - m_size < text.size())
+	{
+		WriteBuffer();
+		// Крупный кусок копировать в буфер незачем
+		if (text.size() >= m_buffer.size())
+		{
+			m_out.write(text.data(), static_cast<std::streamsize>(text.size()));
+			return;
+		}
+	}
+	std::memcpy(m_buffer.data() + m_size, text.data(), text.size());
+	m_size += text.size();
+}
+
+void BufferedWriter::WriteFixed(double value, int precision)
+{
+	// Знак, 309 цифр целой части DBL_MAX, точка и знаки после неё
+	const size_t maxLength = 311 + static_cast<size_t>(precision);
+	char* pos = Reserve(maxLength);
+	// to_chars с точностью форматирует как printf("%.*f"), то есть так же, как std::fixed
+	Commit(std::to_chars(pos, pos + maxLength, value, std::chars_format::fixed, precision).ptr);
+}
+
+char* BufferedWriter::Reserve(size_t size)
+{
+	if (m_buffer.size() - m_size < size)
+	{
+		WriteBuffer();
+	}
+	return m_buffer.data() + m_size;
+}
+
+void BufferedWriter::Commit(char* end)
+{
+	m_size = end - m_buffer.data();
+}
+
+void BufferedWriter::Flush()
+{
+	WriteBuffer();
+	m_out.flush();
+}
+
+void BufferedWriter::WriteBuffer()
+{
+	if (m_size != 0)
+	{
+		m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+		m_size = 0;
+	}
+}
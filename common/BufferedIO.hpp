@@ -0,0 +1,84 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+const size_t IO_BLOCK_SIZE = 1 << 20;
+
+// Читает поток блоками по blockSize байт в собственный буфер, минуя посимвольный разбор iostream
+class BufferedReader
+{
+public:
+	explicit BufferedReader(std::istream& in, size_t blockSize = IO_BLOCK_SIZE);
+
+	// Очередной блок, пустой, когда поток закончился. Действителен до следующего чтения
+	std::span<char> ReadBlock();
+
+	// Как std::getline: строка без '\n', false, если поток закончился раньше, чем началась строка
+	bool ReadLine(std::string& line);
+
+private:
+	bool Fill();
+
+	std::istream& m_in;
+	std::vector<char> m_buffer;
+	size_t m_pos = 0;
+	size_t m_size = 0;
+};
+
+// Читает поток до конца. Ошибку чтения вызывающий код видит по состоянию потока, как после in.read
+std::vector<char> ReadAll(std::istream& in);
+
+// Копит вывод в буфере и отдаёт его в поток блоками по bufferSize байт.
+// Поток сбрасывается только в Flush, а не после каждой строки, как при std::endl
+class BufferedWriter
+{
+public:
+	explicit BufferedWriter(std::ostream& out, size_t bufferSize = IO_BLOCK_SIZE);
+	// Дописывает в поток то, что осталось в буфере
+	~BufferedWriter();
+
+	BufferedWriter(const BufferedWriter&) = delete;
+	BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+	void Write(std::string_view text);
+	void Put(char ch)
+	{
+		if (m_size == m_buffer.size())
+		{
+			WriteBuffer();
+		}
+		m_buffer[m_size++] = ch;
+	}
+
+	template <std::integral T>
+	void WriteInteger(T value)
+	{
+		// Знак и 20 цифр UINT64_MAX
+		char* pos = Reserve(21);
+		Commit(std::to_chars(pos, pos + 21, value).ptr);
+	}
+
+	// Число с precision знаками после точки, побайтно как std::fixed и std::setprecision(precision)
+	void WriteFixed(double value, int precision);
+
+	// Место под запись не меньше size байт (size не больше размера буфера). Запись завершает Commit
+	char* Reserve(size_t size);
+	void Commit(char* end);
+
+	// Отдаёт буфер в поток и сбрасывает сам поток
+	void Flush();
+
+private:
+	void WriteBuffer();
+
+	std::ostream& m_out;
+	std::vector<char> m_buffer;
+	size_t m_size = 0;
+};
@@ -0,0 +1,59 @@
+#include "CharConv.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+bool IsDigit(char ch)
+{
+	return ch >= '0' && ch <= '9';
+}
+
+ParseResult Fail(const char* stop, const char* end)
+{
+	return stop == end ? ParseResult::EndOfInput : ParseResult::BadValue;
+}
+} // namespace
+
+ParseResult ParseDouble(const char*& pos, const char* end, double& number)
+{
+	const char* first = pos;
+	if (*first == '+')
+	{
+		++first;
+	}
+	const char* mantissa = (first != end && *first == '-' && first == pos) ? first + 1 : first;
+	if (mantissa == end || !(IsDigit(*mantissa) || *mantissa == '.'))
+	{
+		return Fail(mantissa, end);
+	}
+
+	auto [last, ec] = std::from_chars(first, end, number);
+	if (ec == std::errc::invalid_argument)
+	{
+		return Fail(mantissa + 1, end);
+	}
+	if (ec == std::errc::result_out_of_range)
+	{
+		number = std::strtod(std::string(first, last).c_str(), nullptr);
+		if (std::isinf(number))
+		{
+			return Fail(last, end);
+		}
+	}
+	// from_chars не берёт экспоненту без цифр, а operator>> съедает её и не может прочитать число
+	if (last != end && (*last == 'e' || *last == 'E') && std::find_if(first, last, [](char ch) { return ch == 'e' || ch == 'E'; }) == last)
+	{
+		++last;
+		if (last != end && (*last == '+' || *last == '-'))
+		{
+			++last;
+		}
+		return Fail(last, end);
+	}
+	pos = last;
+	return ParseResult::Number;
+}
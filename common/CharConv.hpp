@@ -0,0 +1,21 @@
+#pragma once
+
+// Разбор чисел через std::from_chars с теми же правилами, что у operator>> в локали "C"
+
+inline bool IsSpace(char ch)
+{
+	return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+enum class ParseResult
+{
+	Number,
+	BadValue,
+	// Число оборвано концом текста: operator>> в этом случае выставляет eof и ошибки не будет
+	EndOfInput,
+};
+
+// Читает double, начиная с непробельного символа pos < end, и сдвигает pos за число.
+// Как operator>>: знак, цифры, точка и экспонента без inf, nan и 0x, переполнение - ошибка,
+// а слишком маленькие по модулю числа читаются как 0 или денормализованные
+ParseResult ParseDouble(const char*& pos, const char* end, double& number);
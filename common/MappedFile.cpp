@@ -0,0 +1,74 @@
+#include "MappedFile.hpp"
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& fileName)
+{
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd == -1)
+	{
+		throw std::system_error(errno, std::generic_category(), "Can't open file " + fileName);
+	}
+
+	struct stat info
+	{
+	};
+	if (fstat(fd, &info) == -1)
+	{
+		int error = errno;
+		close(fd);
+		throw std::system_error(error, std::generic_category(), "Can't stat file " + fileName);
+	}
+
+	m_size = static_cast<size_t>(info.st_size);
+	if (m_size != 0)
+	{
+		void* data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED)
+		{
+			int error = errno;
+			close(fd);
+			throw std::system_error(error, std::generic_category(), "Can't map file " + fileName);
+		}
+		m_data = static_cast<char*>(data);
+		madvise(m_data, m_size, MADV_SEQUENTIAL);
+	}
+	close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_data != nullptr)
+	{
+		munmap(m_data, m_size);
+	}
+}
+#else
+#include <fstream>
+
+// Без mmap файл целиком читается в собственный буфер
+MappedFile::MappedFile(const std::string& fileName)
+{
+	std::ifstream input(fileName, std::ios::binary | std::ios::ate);
+	if (!input.is_open())
+	{
+		throw std::system_error(errno, std::generic_category(), "Can't open file " + fileName);
+	}
+	m_size = static_cast<size_t>(input.tellg());
+	m_data = new char[m_size];
+	input.seekg(0);
+	input.read(m_data, static_cast<std::streamsize>(m_size));
+}
+
+MappedFile::~MappedFile()
+{
+	delete[] m_data;
+}
+#endif
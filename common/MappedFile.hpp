@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Файл, отображённый в память с копированием при записи:
+// изменения видны только этому процессу и не попадают в исходный файл
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::string& fileName);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	char* Data() const { return m_data; }
+	size_t Size() const { return m_size; }
+
+private:
+	char* m_data = nullptr;
+	size_t m_size = 0;
+};
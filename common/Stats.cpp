@@ -0,0 +1,171 @@
+#include "Stats.hpp"
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+bool g_statsEnabled = false;
+std::chrono::steady_clock::time_point g_statsStart;
+
+// ru_maxrss в Linux в КиБ, а в macOS в байтах
+uint64_t GetPeakRssKib()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+#if defined(__APPLE__)
+	return static_cast<uint64_t>(usage.ru_maxrss) / 1024;
+#else
+	return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+#else
+	return 0;
+#endif
+}
+
+#if defined(LAB_STATS)
+std::atomic<uint64_t> g_allocations = 0;
+std::atomic<uint64_t> g_allocatedBytes = 0;
+
+std::mutex g_entriesMutex;
+// deque не перемещает записи при добавлении, поэтому ссылки на них остаются действительными
+std::deque<StatsEntry> g_entries;
+
+int64_t GetNanoseconds()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Имена фаз - строковые литералы из кода, экранировать в них нечего
+void PrintStatsEntries(std::ostream& out)
+{
+	std::lock_guard lock(g_entriesMutex);
+
+	out << "  \"phases\": {";
+	const char* separator = "\n";
+	for (const StatsEntry& entry : g_entries)
+	{
+		if (entry.calls == 0 && entry.bytes == 0)
+		{
+			continue;
+		}
+		const double seconds = entry.nanoseconds / 1e9;
+		out << separator << "    \"" << entry.name << "\": { \"seconds\": " << std::setprecision(6) << seconds
+			<< ", \"calls\": " << entry.calls << ", \"bytes\": " << entry.bytes;
+		if (seconds > 0 && entry.bytes != 0)
+		{
+			out << ", \"mib_per_second\": " << std::setprecision(1) << entry.bytes / seconds / (1 << 20);
+		}
+		out << " }";
+		separator = ",\n";
+	}
+	out << (*separator == ',' ? "\n  },\n" : "},\n");
+
+	out << "  \"counters\": {";
+	separator = "\n";
+	for (const StatsEntry& entry : g_entries)
+	{
+		if (entry.count != 0)
+		{
+			out << separator << "    \"" << entry.name << "\": " << entry.count;
+			separator = ",\n";
+		}
+	}
+	out << (*separator == ',' ? "\n  },\n" : "},\n");
+
+	out << "  \"allocations\": { \"count\": " << g_allocations << ", \"bytes\": " << g_allocatedBytes << " },\n";
+}
+#endif
+} // namespace
+
+void EnableStats()
+{
+	g_statsEnabled = true;
+	g_statsStart = std::chrono::steady_clock::now();
+}
+
+bool IsStatsEnabled()
+{
+	return g_statsEnabled;
+}
+
+void PrintStats(std::ostream& out)
+{
+	const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - g_statsStart;
+	out << "{\n"
+		<< std::fixed << "  \"wall_seconds\": " << std::setprecision(6) << wall.count() << ",\n";
+#if defined(LAB_STATS)
+	PrintStatsEntries(out);
+#endif
+	out << "  \"peak_rss_kib\": " << GetPeakRssKib() << "\n"
+		<< "}" << std::endl;
+}
+
+StatsReport::StatsReport(int& argc, char* argv[])
+{
+	// Только первым аргументом, иначе "--stats" нельзя было бы передать программе как обычную строку
+	if (argc > 1 && std::strcmp(argv[1], "--stats") == 0)
+	{
+		// Сдвигаем и завершающий nullptr
+		std::memmove(argv + 1, argv + 2, (argc - 1) * sizeof(char*));
+		argc--;
+		EnableStats();
+	}
+}
+
+StatsReport::~StatsReport()
+{
+	if (g_statsEnabled)
+	{
+		PrintStats(std::cerr);
+	}
+}
+
+#if defined(LAB_STATS)
+StatsEntry& GetStatsEntry(const char* name)
+{
+	std::lock_guard lock(g_entriesMutex);
+	for (StatsEntry& entry : g_entries)
+	{
+		if (std::strcmp(entry.name, name) == 0)
+		{
+			return entry;
+		}
+	}
+	return g_entries.emplace_back(name);
+}
+
+ScopedTimer::ScopedTimer(StatsEntry& entry)
+	: m_entry(entry)
+	, m_start(g_statsEnabled ? GetNanoseconds() : -1)
+{
+}
+
+ScopedTimer::~ScopedTimer()
+{
+	if (m_start >= 0)
+	{
+		m_entry.nanoseconds += GetNanoseconds() - m_start;
+		m_entry.calls++;
+	}
+}
+
+void CountAllocation(std::size_t size)
+{
+	if (g_statsEnabled)
+	{
+		g_allocations.fetch_add(1, std::memory_order_relaxed);
+		g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	}
+}
+#endif
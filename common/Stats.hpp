@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+// Замеры для флага --stats: время фаз, объём обработанных данных и счётчики.
+// Без LAB_STATS макросы STATS_* ничего не делают, а отчёт содержит только пиковую память.
+// Со LAB_STATS, пока замеры не включены EnableStats, каждый макрос сводится к проверке флага
+
+// Включает замеры и запоминает время начала работы
+void EnableStats();
+bool IsStatsEnabled();
+
+// Пишет отчёт в JSON: фазы с временем, числом вызовов, байтами и скоростью, счётчики,
+// общее время, пиковый размер резидентной памяти и число выделений памяти через new
+void PrintStats(std::ostream& out);
+
+// Включает замеры, если первый аргумент --stats, и убирает его из argv,
+// чтобы остальные аргументы разбирались как раньше. При выходе из main пишет отчёт в stderr
+class StatsReport
+{
+public:
+	StatsReport(int& argc, char* argv[]);
+	~StatsReport();
+
+	StatsReport(const StatsReport&) = delete;
+	StatsReport& operator=(const StatsReport&) = delete;
+};
+
+#if defined(LAB_STATS)
+// Фаза или счётчик. Записи с одним именем из разных мест кода - одна запись
+struct StatsEntry
+{
+	const char* name;
+	std::atomic<uint64_t> nanoseconds = 0;
+	std::atomic<uint64_t> calls = 0;
+	std::atomic<uint64_t> bytes = 0;
+	std::atomic<uint64_t> count = 0;
+};
+
+StatsEntry& GetStatsEntry(const char* name);
+
+// Учитывает выделение памяти, если замеры включены. Вызывается из operator new в allocstats
+void CountAllocation(std::size_t size);
+
+// Добавляет к фазе время жизни объекта
+class ScopedTimer
+{
+public:
+	explicit ScopedTimer(StatsEntry& entry);
+	~ScopedTimer();
+
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+	StatsEntry& m_entry;
+	int64_t m_start;
+};
+
+#define STATS_JOIN_IMPL(a, b) a##b
+#define STATS_JOIN(a, b) STATS_JOIN_IMPL(a, b)
+
+// Запись ищется по имени один раз на место вызова
+#define STATS_SCOPE(name)                                                          \
+	static StatsEntry& STATS_JOIN(statsEntry, __LINE__) = GetStatsEntry(name);     \
+	ScopedTimer STATS_JOIN(statsTimer, __LINE__)(STATS_JOIN(statsEntry, __LINE__))
+
+#define STATS_ADD(name, field, value)                                              \
+	do                                                                             \
+	{                                                                              \
+		if (IsStatsEnabled())                                                      \
+		{                                                                          \
+			static StatsEntry& statsEntry = GetStatsEntry(name);                   \
+			statsEntry.field += (value);                                           \
+		}                                                                          \
+	} while (false)
+
+#define STATS_BYTES(name, value) STATS_ADD(name, bytes, value)
+#define STATS_COUNT(name, value) STATS_ADD(name, count, value)
+#else
+#define STATS_SCOPE(name)
+#define STATS_BYTES(name, value) ((void)0)
+#define STATS_COUNT(name, value) ((void)0)
+#endif
@@ -1,13 +1,19 @@
+#include "BufferedIO.hpp"
+#include "Stats.hpp"
+#include <array>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <system_error>
 
 const std::string HELP_TEXT = "Usage:\n"
-							  "To crypt data use: crypt <mode> <input file> <output file> <key>\n"
+							  "To crypt data use: crypt [--stats] <mode> <input file> <output file> <key>\n"
 							  "Programm will read data from input file, crypt or decrypt it using provided key and write result to output file.\n"
 							  "Parameters:\n"
 							  "\t- <mode> should be either 'crypt' or 'decrypt'.\n"
-							  "\t- <key> should be a number in range [0, 255].";
+							  "\t- <key> should be a number in range [0, 255].\n"
+							  "With --stats prints phase timings, peak memory and allocation counts to stderr as JSON.";
 
 const std::string CRYPT_MODE = "crypt";
 const std::string DECRYPT_MODE = "decrypt";
@@ -55,16 +61,49 @@ void ProcessFiles(const std::string& inputFile, const std::string& outputFile, c
 	
 	ValidateFiles(inputFile, outputFile, in, out);
 
-	char byte;
-	while (in.get(byte))
+	// Каждый байт преобразуется независимо от остальных, поэтому хватает таблицы на все 256 значений
+	std::array<char, 256> table;
+	for (unsigned byte = 0; byte < table.size(); byte++)
 	{
-		char res = mode == CRYPT_MODE ? CryptByte(byte, key) : DecryptByte(byte, key);
-		out.put(res);
+		table[byte] = static_cast<char>(mode == CRYPT_MODE ? CryptByte(byte, key) : DecryptByte(byte, key));
 	}
+
+	BufferedReader reader(in);
+	BufferedWriter writer(out);
+	while (true)
+	{
+		std::span<char> block;
+		{
+			STATS_SCOPE("read");
+			block = reader.ReadBlock();
+			STATS_BYTES("read", block.size());
+		}
+		if (block.empty())
+		{
+			break;
+		}
+
+		{
+			STATS_SCOPE("crypt");
+			for (char& byte : block)
+			{
+				byte = table[static_cast<uint8_t>(byte)];
+			}
+			STATS_BYTES("crypt", block.size());
+		}
+
+		STATS_SCOPE("write");
+		writer.Write(std::string_view(block.data(), block.size()));
+		STATS_BYTES("write", block.size());
+	}
+
+	STATS_SCOPE("write");
+	writer.Flush();
 }
 
 int main(int argc, char* argv[])
 {
+	StatsReport stats(argc, argv);
 	if (argc == 2 && std::string(argv[1]) == "-h")
 	{
 		std::cout << HELP_TEXT << std::endl;
@@ -1,5 +1,6 @@
 #include "MatrixMath.hpp"
-#include "Exceptions.hpp"
+#include "Stats.hpp"
+#include "exceptions.hpp"
 #include <string>
 
 double Determinant(const Matrix& matrix)
@@ -63,6 +64,7 @@ Matrix TransposeMatrix(const Matrix& matrix)
 
 Matrix InvertMatrix(const Matrix& matrix)
 {
+	STATS_SCOPE("invert");
 	double det = Determinant(matrix);
 	if (det == 0)
 	{
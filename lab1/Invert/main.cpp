@@ -1,14 +1,49 @@
-#include "Exceptions.hpp"
+#include "BufferedIO.hpp"
+#include "CharConv.hpp"
+#include "MappedFile.hpp"
 #include "MatrixMath.hpp"
-#include <fstream>
+#include "Stats.hpp"
+#include "exceptions.hpp"
+#include <algorithm>
 #include <iostream>
-#include <sstream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <vector>
 
-const std::string HELP_TEXT = "Usage: invert <input file>\n"
+const std::string HELP_TEXT = "Usage: invert [--stats] <input file>\n"
 							  "If u don't provide an input file, the program will read from standard input line by line.\n"
-							  "Proggram works with square matrices of 3x3 size. Matrix will be inverted and returned as output.\n";
+							  "Proggram works with square matrices of 3x3 size. Matrix will be inverted and returned as output.\n"
+							  "With --stats prints phase timings, peak memory and allocation counts to stderr as JSON.\n";
+
+// Читает до трёх чисел строки так же, как цикл iss >> value по istringstream от неё
+VecD ParseRow(std::string_view line)
+{
+	VecD row;
+	const char* pos = line.data();
+	const char* end = pos + line.size();
+	while (row.size() < 3)
+	{
+		pos = std::find_if_not(pos, end, IsSpace);
+		if (pos == end)
+		{
+			break;
+		}
+		double value;
+		ParseResult result = ParseDouble(pos, end, value);
+		if (result == ParseResult::BadValue)
+		{
+			throw InvalidMatrixException("Non-numeric value encountered in input");
+		}
+		if (result == ParseResult::EndOfInput)
+		{
+			break;
+		}
+		row.push_back(value);
+	}
+	return row;
+}
 
 Matrix ReadMatrix(std::istream& input)
 {
@@ -17,19 +52,22 @@ Matrix ReadMatrix(std::istream& input)
 
 	while (std::getline(input, line) && matrix.size() < 3)
 	{
-		std::istringstream iss(line);
+		matrix.push_back(ParseRow(line));
+	}
 
-		VecD row;
-		double value;
-		while (row.size() < 3 && (iss >> value))
-		{
-			row.push_back(value);
-		}
-		if (iss.fail() && !iss.eof())
-		{
-			throw InvalidMatrixException("Non-numeric value encountered in input");
-		}
-		matrix.push_back(row);
+	return matrix;
+}
+
+// Строки текста разбираются, как если бы они читались через std::getline
+Matrix ReadMatrix(std::string_view text)
+{
+	Matrix matrix;
+
+	while (!text.empty() && matrix.size() < 3)
+	{
+		size_t lineEnd = text.find('\n');
+		matrix.push_back(ParseRow(text.substr(0, lineEnd)));
+		text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
 	}
 
 	return matrix;
@@ -37,15 +75,18 @@ Matrix ReadMatrix(std::istream& input)
 
 Matrix PrintMatrix(const Matrix& matrix, std::ostream& output)
 {
-	output << std::fixed << std::setprecision(3);
+	STATS_SCOPE("write");
+	BufferedWriter writer(output);
 	for (const auto& row : matrix)
 	{
 		for (const auto& elem : row)
 		{
-			output << elem << "\t";
+			writer.WriteFixed(elem, 3);
+			writer.Put('\t');
 		}
-		output << std::endl;
+		writer.Put('\n');
 	}
+	writer.Flush();
 	return matrix;
 }
 
@@ -100,16 +141,22 @@ ProgrammArgs ParseArguments(int argc, char* argv[])
 
 Matrix GetMatrix(const ProgrammArgs& args)
 {
+	STATS_SCOPE("read");
 	Matrix matrix;
 
 	if (args.mode == ProgrammMode::FILE)
 	{
-		std::ifstream inputFile(args.inputFile);
-		if (!inputFile.is_open())
+		std::unique_ptr<MappedFile> inputFile;
+		try
+		{
+			inputFile = std::make_unique<MappedFile>(args.inputFile);
+		}
+		catch (const std::system_error&)
 		{
 			throw std::runtime_error("Error: Could not open file " + args.inputFile);
 		}
-		matrix = ReadMatrix(inputFile);
+		STATS_BYTES("read", inputFile->Size());
+		matrix = ReadMatrix(std::string_view(inputFile->Data(), inputFile->Size()));
 	}
 	else if (args.mode == ProgrammMode::STDIN)
 	{
@@ -125,6 +172,7 @@ Matrix GetMatrix(const ProgrammArgs& args)
 
 int main(int argc, char* argv[])
 {
+	StatsReport stats(argc, argv);
 	auto args = ParseArguments(argc, argv);
 
 	if (args.mode == ProgrammMode::INVALID)
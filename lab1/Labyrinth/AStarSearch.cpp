@@ -0,0 +1,60 @@
+#include "AStarSearch.hpp"
+#include "BucketQueue.hpp"
+#include <cstdlib>
+#include <stdexcept>
+
+uint32_t ManhattanDistance(Position from, Position to, size_t stride)
+{
+	int64_t dy = static_cast<int64_t>(from / stride) - static_cast<int64_t>(to / stride);
+	int64_t dx = static_cast<int64_t>(from % stride) - static_cast<int64_t>(to % stride);
+	return static_cast<uint32_t>(std::llabs(dy) + std::llabs(dx));
+}
+
+Path AStarSearch(const Labyrinth& labyrinth, SearchStats& stats)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+
+	RoadMap roadMap = CreateRoadMap(labyrinth);
+	std::vector<uint32_t>& dist = roadMap.dist;
+	const auto offsets = GetDirectionOffsets(labyrinth.stride);
+
+	// Шаг меняет эвристику на ±1, поэтому приоритет соседа больше текущего не более чем на 2
+	BucketQueue queue(2);
+	uint32_t startPriority = ManhattanDistance(a, b, labyrinth.stride);
+	queue.Reset(startPriority);
+
+	dist[a] = 0;
+	queue.Push(startPriority, a);
+
+	while (!queue.Empty())
+	{
+		Position current = queue.Pop();
+		uint32_t priority = queue.CurrentKey();
+
+		// Устаревшая запись: клетка уже была извлечена с меньшим приоритетом
+		if (dist[current] + ManhattanDistance(current, b, labyrinth.stride) != priority)
+		{
+			continue;
+		}
+		stats.expanded++;
+
+		if (current == b)
+		{
+			return RestorePath(roadMap, a, b);
+		}
+
+		uint32_t nextDist = dist[current] + 1;
+		for (std::ptrdiff_t offset : offsets)
+		{
+			Position next = static_cast<Position>(current + offset);
+			if (dist[next] == BLOCKED || dist[next] <= nextDist)
+			{
+				continue;
+			}
+			dist[next] = nextDist;
+			queue.Push(nextDist + ManhattanDistance(next, b, labyrinth.stride), next);
+		}
+	}
+
+	throw std::runtime_error("Can't find path");
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include "WaveAlgorithm.hpp"
+
+uint32_t ManhattanDistance(Position from, Position to, size_t stride);
+
+// A* с манхэттенской эвристикой. Все рёбра единичные, поэтому вместо кучи используется BucketQueue
+Path AStarSearch(const Labyrinth& labyrinth, SearchStats& stats);
@@ -0,0 +1,80 @@
+#include "BidirectionalSearch.hpp"
+#include "FrontierQueue.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+// Расширяет один слой волны. Возвращает позицию лучшей встречи с другой волной или NO_POSITION
+Position ExpandLayer(FrontierQueue& queue, std::vector<uint32_t>& own, const std::vector<uint32_t>& other,
+	const std::array<std::ptrdiff_t, 4>& offsets, uint64_t& bestLength, SearchStats& stats)
+{
+	Position meeting = NO_POSITION;
+	for (size_t layerSize = queue.Size(); layerSize > 0; layerSize--)
+	{
+		Position current = queue.Pop();
+		stats.expanded++;
+
+		uint32_t nextDist = own[current] + 1;
+		for (std::ptrdiff_t offset : offsets)
+		{
+			Position next = static_cast<Position>(current + offset);
+			if (own[next] != UNVISITED)
+			{
+				continue;
+			}
+			own[next] = nextDist;
+			queue.Push(next);
+
+			if (other[next] < BLOCKED && nextDist + static_cast<uint64_t>(other[next]) < bestLength)
+			{
+				bestLength = nextDist + static_cast<uint64_t>(other[next]);
+				meeting = next;
+			}
+		}
+	}
+	return meeting;
+}
+} // namespace
+
+Path BidirectionalSearch(const Labyrinth& labyrinth, SearchStats& stats)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+
+	RoadMap fromStart = CreateRoadMap(labyrinth);
+	RoadMap fromEnd = fromStart;
+	const auto offsets = GetDirectionOffsets(labyrinth.stride);
+
+	FrontierQueue startQueue(labyrinth.stride + labyrinth.height);
+	FrontierQueue endQueue(labyrinth.stride + labyrinth.height);
+
+	fromStart.dist[a] = 0;
+	startQueue.Push(a);
+	fromEnd.dist[b] = 0;
+	endQueue.Push(b);
+
+	uint64_t bestLength = UINT64_MAX;
+	Position meeting = NO_POSITION;
+
+	while (meeting == NO_POSITION && !startQueue.Empty() && !endQueue.Empty())
+	{
+		if (startQueue.Size() <= endQueue.Size())
+		{
+			meeting = ExpandLayer(startQueue, fromStart.dist, fromEnd.dist, offsets, bestLength, stats);
+		}
+		else
+		{
+			meeting = ExpandLayer(endQueue, fromEnd.dist, fromStart.dist, offsets, bestLength, stats);
+		}
+	}
+
+	if (meeting == NO_POSITION)
+	{
+		throw std::runtime_error("Can't find path");
+	}
+
+	Path path = RestorePath(fromStart, a, meeting);
+	Path tail = RestorePath(fromEnd, b, meeting);
+	path.insert(path.end(), tail.rbegin() + 1, tail.rend());
+	return path;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include "WaveAlgorithm.hpp"
+
+// Волна запускается одновременно из 'A' и из 'B' и каждый раз расширяет меньший фронт на один слой.
+// После первой встречи слой дорабатывается до конца, и выбирается кратчайшая из найденных стыковок
+Path BidirectionalSearch(const Labyrinth& labyrinth, SearchStats& stats);
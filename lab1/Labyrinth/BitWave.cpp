@@ -0,0 +1,166 @@
+#include "BitWave.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace
+{
+// Битовая сетка: строки по rowWords слов, последнее слово строки и строки 0 и height + 1 всегда нулевые,
+// поэтому соседние слова и строки читаются без проверок границ
+struct BitGrid
+{
+	size_t width = 0;
+	size_t height = 0;
+	size_t rowWords = 0;
+
+	size_t WordIndex(size_t row, size_t column) const { return row * rowWords + column / 64; }
+
+	bool Test(const std::vector<uint64_t>& plane, size_t row, size_t column) const
+	{
+		return (plane[WordIndex(row, column)] >> (column % 64)) & 1;
+	}
+};
+
+std::vector<uint64_t> CreateFreePlane(const Labyrinth& labyrinth, const BitGrid& grid)
+{
+	std::vector<uint64_t> free((grid.height + 2) * grid.rowWords, 0);
+	for (size_t y = 0; y < labyrinth.height; y++)
+	{
+		const char* row = labyrinth.cells.data() + y * labyrinth.stride;
+		for (size_t x = 0; x < grid.width; x++)
+		{
+			if (row[x] != WALL && row[x] != PADDING)
+			{
+				free[grid.WordIndex(y + 1, x)] |= uint64_t(1) << (x % 64);
+			}
+		}
+	}
+	return free;
+}
+
+uint32_t GetLayerMod3(const std::vector<uint64_t>& low, const std::vector<uint64_t>& high,
+	const BitGrid& grid, size_t row, size_t column)
+{
+	return static_cast<uint32_t>(grid.Test(low, row, column)) | static_cast<uint32_t>(grid.Test(high, row, column)) << 1;
+}
+} // namespace
+
+Path BitWaveSearch(const Labyrinth& labyrinth, SearchStats& stats)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+
+	BitGrid grid;
+	grid.width = labyrinth.stride - 1;
+	grid.height = labyrinth.height;
+	grid.rowWords = (grid.width + 63) / 64 + 1;
+
+	const std::vector<uint64_t> free = CreateFreePlane(labyrinth, grid);
+	std::vector<uint64_t> visited(free.size(), 0);
+	std::vector<uint64_t> current(free.size(), 0);
+	std::vector<uint64_t> next(free.size(), 0);
+	std::vector<uint64_t> layerLow(free.size(), 0);
+	std::vector<uint64_t> layerHigh(free.size(), 0);
+
+	// Position уже содержит сдвиг на одну строку, как и номер строки битовой сетки
+	const size_t startRow = a / labyrinth.stride;
+	const size_t startColumn = a % labyrinth.stride;
+	const size_t endRow = b / labyrinth.stride;
+	const size_t endColumn = b % labyrinth.stride;
+
+	// Фронт хранится и как битовая плоскость, и как список ненулевых слов:
+	// за слой обрабатываются только эти слова и их соседи, а не вся сетка
+	const size_t startWord = grid.WordIndex(startRow, startColumn);
+	current[startWord] |= uint64_t(1) << (startColumn % 64);
+	visited[startWord] |= uint64_t(1) << (startColumn % 64);
+	stats.expanded++;
+
+	const size_t firstWord = grid.rowWords;
+	const size_t lastWord = (grid.height + 1) * grid.rowWords;
+	std::vector<size_t> activeWords = { startWord };
+	std::vector<size_t> nextActiveWords;
+
+	uint32_t layer = 0;
+	bool reached = false;
+
+	while (!reached && !activeWords.empty())
+	{
+		layer++;
+		const uint64_t lowMask = (layer % 3) & 1 ? ~uint64_t(0) : 0;
+		const uint64_t highMask = (layer % 3) & 2 ? ~uint64_t(0) : 0;
+
+		// Слово может попасть сюда несколько раз от разных соседей, но повторно ничего нового не даст
+		auto expandWord = [&](size_t w) {
+			if (w < firstWord || w >= lastWord)
+			{
+				return;
+			}
+			uint64_t cells = current[w];
+			uint64_t spread = (cells << 1) | (cells >> 1) | (current[w - 1] >> 63) | (current[w + 1] << 63)
+				| current[w - grid.rowWords] | current[w + grid.rowWords];
+			uint64_t reachedCells = spread & free[w] & ~visited[w];
+			if (reachedCells != 0)
+			{
+				next[w] = reachedCells;
+				visited[w] |= reachedCells;
+				layerLow[w] |= reachedCells & lowMask;
+				layerHigh[w] |= reachedCells & highMask;
+				stats.expanded += std::popcount(reachedCells);
+				nextActiveWords.push_back(w);
+			}
+		};
+
+		nextActiveWords.clear();
+		for (size_t w : activeWords)
+		{
+			expandWord(w);
+			expandWord(w - 1);
+			expandWord(w + 1);
+			expandWord(w - grid.rowWords);
+			expandWord(w + grid.rowWords);
+		}
+
+		// Очищаем отработавший фронт, чтобы буфер снова был нулевым вне списка активных слов
+		for (size_t w : activeWords)
+		{
+			current[w] = 0;
+		}
+		current.swap(next);
+		activeWords.swap(nextActiveWords);
+		reached = grid.Test(visited, endRow, endColumn);
+	}
+
+	if (!reached)
+	{
+		throw std::runtime_error("Can't find path");
+	}
+
+	// Восстановление пути: из клетки слоя k переходим к соседу слоя k - 1 в порядке restoreDirections
+	Path path(layer + 1);
+	size_t row = endRow;
+	size_t column = endColumn;
+	for (uint32_t k = layer; k > 0; k--)
+	{
+		path[k] = static_cast<Position>(row * labyrinth.stride + column);
+		const uint32_t previousMod3 = (k - 1) % 3;
+		bool found = false;
+		for (auto it = DIRECTIONS.rbegin(); it != DIRECTIONS.rend() && !found; ++it)
+		{
+			size_t nextRow = row + it->first;
+			size_t nextColumn = column + it->second;
+			if (nextColumn >= grid.width || !grid.Test(visited, nextRow, nextColumn)
+				|| GetLayerMod3(layerLow, layerHigh, grid, nextRow, nextColumn) != previousMod3)
+			{
+				continue;
+			}
+			row = nextRow;
+			column = nextColumn;
+			found = true;
+		}
+		if (!found)
+		{
+			throw std::runtime_error("Path restoration failed");
+		}
+	}
+	path[0] = a;
+	return path;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include "WaveAlgorithm.hpp"
+
+// Волна над битовыми масками строк: слой целиком получается словными операциями
+// next = (влево | вправо | вверх | вниз) & free & ~visited, по 64 клетки за операцию.
+// Вместо расстояний хранится номер слоя по модулю 3 (две битовые плоскости) - этого достаточно,
+// чтобы восстановить путь с тем же порядком обхода соседей, что и RestorePath
+Path BitWaveSearch(const Labyrinth& labyrinth, SearchStats& stats);
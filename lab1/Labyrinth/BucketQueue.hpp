@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Монотонная очередь с приоритетами для целых ключей (очередь Дейкстры-Дайла).
+// Ключ добавляемого элемента лежит в [CurrentKey(), CurrentKey() + maxDelta],
+// поэтому хватает maxDelta + 1 корзин, используемых по кругу
+class BucketQueue
+{
+public:
+	explicit BucketQueue(uint32_t maxDelta)
+		: m_buckets(maxDelta + 1)
+	{
+	}
+
+	bool Empty() const { return m_size == 0; }
+
+	uint32_t CurrentKey() const { return m_currentKey; }
+
+	void Push(uint32_t key, uint32_t item)
+	{
+		m_buckets[key % m_buckets.size()].push_back(item);
+		m_size++;
+	}
+
+	// Извлекает последний добавленный элемент с минимальным ключом
+	uint32_t Pop()
+	{
+		while (m_buckets[m_currentKey % m_buckets.size()].empty())
+		{
+			m_currentKey++;
+		}
+		std::vector<uint32_t>& bucket = m_buckets[m_currentKey % m_buckets.size()];
+		uint32_t item = bucket.back();
+		bucket.pop_back();
+		m_size--;
+		return item;
+	}
+
+	void Reset(uint32_t startKey)
+	{
+		for (auto& bucket : m_buckets)
+		{
+			bucket.clear();
+		}
+		m_size = 0;
+		m_currentKey = startKey;
+	}
+
+private:
+	std::vector<std::vector<uint32_t>> m_buckets;
+	size_t m_size = 0;
+	uint32_t m_currentKey = 0;
+};
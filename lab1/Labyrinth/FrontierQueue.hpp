@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+// Кольцевая очередь индексов клеток. Ёмкость - степень двойки, при переполнении удваивается
+class FrontierQueue
+{
+public:
+	explicit FrontierQueue(size_t capacity)
+		: m_items(std::bit_ceil(std::max<size_t>(capacity, 16)))
+		, m_mask(m_items.size() - 1)
+	{
+	}
+
+	bool Empty() const { return m_head == m_tail; }
+
+	size_t Size() const { return m_tail - m_head; }
+
+	void Push(uint32_t item)
+	{
+		if (Size() == m_items.size())
+		{
+			Grow();
+		}
+		m_items[m_tail++ & m_mask] = item;
+	}
+
+	uint32_t Pop() { return m_items[m_head++ & m_mask]; }
+
+	void Clear() { m_head = m_tail = 0; }
+
+private:
+	void Grow()
+	{
+		std::vector<uint32_t> items(m_items.size() * 2);
+		for (size_t i = 0; i < Size(); i++)
+		{
+			items[i] = m_items[(m_head + i) & m_mask];
+		}
+		m_tail = Size();
+		m_head = 0;
+		m_items.swap(items);
+		m_mask = m_items.size() - 1;
+	}
+
+	std::vector<uint32_t> m_items;
+	size_t m_mask;
+	size_t m_head = 0;
+	size_t m_tail = 0;
+};
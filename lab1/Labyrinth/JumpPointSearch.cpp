@@ -0,0 +1,335 @@
+#include "JumpPointSearch.hpp"
+#include "AStarSearch.hpp"
+#include "BucketQueue.hpp"
+#include "ParentWave.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+const size_t NO_BIT = SIZE_MAX;
+
+// Стоимость пути хранится только для точек прыжка: на открытых лабиринтах их единицы,
+// и полная карта расстояний стоила бы дороже самого поиска
+using JumpCosts = std::unordered_map<Position, uint32_t>;
+
+uint32_t GetCost(const JumpCosts& costs, Position pos)
+{
+	auto it = costs.find(pos);
+	return it == costs.end() ? UNVISITED : it->second;
+}
+
+enum Direction : uint8_t
+{
+	UP = 0,
+	DOWN = 1,
+	LEFT = 2,
+	RIGHT = 3,
+};
+
+size_t FindNextBit(const uint64_t* words, size_t wordCount, size_t from)
+{
+	size_t w = from / 64;
+	if (w >= wordCount)
+	{
+		return NO_BIT;
+	}
+	uint64_t word = words[w] & (~uint64_t(0) << (from % 64));
+	while (word == 0)
+	{
+		if (++w == wordCount)
+		{
+			return NO_BIT;
+		}
+		word = words[w];
+	}
+	return w * 64 + std::countr_zero(word);
+}
+
+size_t FindPreviousBit(const uint64_t* words, size_t from)
+{
+	size_t w = from / 64;
+	uint64_t word = words[w] & (~uint64_t(0) >> (63 - from % 64));
+	while (word == 0)
+	{
+		if (w-- == 0)
+		{
+			return NO_BIT;
+		}
+		word = words[w];
+	}
+	return w * 64 + 63 - std::countl_zero(word);
+}
+
+// Строки сетки нумеруются как в Position: строки 0 и height + 1 - рамка из стен.
+// Столбцы хранятся транспонированными, без рамки: бит y столбца x - клетка строки y + 1
+class JumpGrid
+{
+public:
+	JumpGrid(const Labyrinth& labyrinth, Position goal)
+		: m_width(labyrinth.stride - 1)
+		, m_height(labyrinth.height)
+		, m_rowWords(m_width / 64 + 1)
+		, m_columnWords(m_height / 64 + 1)
+		, m_free((m_height + 2) * m_rowWords, 0)
+		, m_rowStops((m_height + 2) * m_rowWords, 0)
+		, m_downStops(m_width * m_columnWords, 0)
+		, m_upStops(m_width * m_columnWords, 0)
+	{
+		// Слово собирается без ветвлений, чтобы компилятор мог векторизовать сравнения
+		for (size_t y = 0; y < m_height; y++)
+		{
+			const char* row = labyrinth.cells.data() + y * labyrinth.stride;
+			for (size_t x = 0; x < m_width; x += 64)
+			{
+				const size_t count = std::min<size_t>(64, m_width - x);
+				uint64_t word = 0;
+				for (size_t i = 0; i < count; i++)
+				{
+					word |= static_cast<uint64_t>((row[x + i] != WALL) & (row[x + i] != PADDING)) << i;
+				}
+				m_free[(y + 1) * m_rowWords + x / 64] = word;
+			}
+		}
+
+		std::vector<uint64_t> goalPlane(m_free.size(), 0);
+		goalPlane[goal / labyrinth.stride * m_rowWords + goal % labyrinth.stride / 64] |= uint64_t(1) << (goal % labyrinth.stride % 64);
+
+		// Вынужденные соседи вертикального хода: сбоку свободно, а сбоку от предыдущей клетки стена
+		std::vector<uint64_t> forcedDown(m_free.size(), 0);
+		std::vector<uint64_t> forcedUp(m_free.size(), 0);
+		for (size_t row = 1; row <= m_height; row++)
+		{
+			for (size_t w = 0; w < m_rowWords; w++)
+			{
+				const uint64_t openAbove = (ShiftFromLeft(row, w) & ~ShiftFromLeft(row - 1, w)) | (ShiftFromRight(row, w) & ~ShiftFromRight(row - 1, w));
+				const uint64_t openBelow = (ShiftFromLeft(row, w) & ~ShiftFromLeft(row + 1, w)) | (ShiftFromRight(row, w) & ~ShiftFromRight(row + 1, w));
+				forcedDown[row * m_rowWords + w] = m_free[row * m_rowWords + w] & openAbove;
+				forcedUp[row * m_rowWords + w] = m_free[row * m_rowWords + w] & openBelow;
+			}
+		}
+
+		// Клетки, из которых вертикальный прыжок вниз или вверх находит точку прыжка до стены.
+		// На них останавливается горизонтальный ход, как и на стенах и цели
+		std::vector<uint64_t> jumpsDown(m_free.size(), 0);
+		std::vector<uint64_t> jumpsUp(m_free.size(), 0);
+		for (size_t row = m_height; row >= 1; row--)
+		{
+			for (size_t w = 0; w < m_rowWords; w++)
+			{
+				const size_t below = (row + 1) * m_rowWords + w;
+				jumpsDown[row * m_rowWords + w] = m_free[below] & (forcedDown[below] | goalPlane[below] | jumpsDown[below]);
+			}
+		}
+		for (size_t row = 1; row <= m_height; row++)
+		{
+			for (size_t w = 0; w < m_rowWords; w++)
+			{
+				const size_t above = (row - 1) * m_rowWords + w;
+				jumpsUp[row * m_rowWords + w] = m_free[above] & (forcedUp[above] | goalPlane[above] | jumpsUp[above]);
+			}
+		}
+		for (size_t i = 0; i < m_rowStops.size(); i++)
+		{
+			m_rowStops[i] = ~m_free[i] | goalPlane[i] | jumpsDown[i] | jumpsUp[i];
+		}
+
+		// Остановки вертикального хода транспонируются в столбцы; за нижней строкой - стена
+		for (size_t x = 0; x < m_width; x++)
+		{
+			for (size_t y = m_height; y < m_columnWords * 64; y++)
+			{
+				m_downStops[x * m_columnWords + y / 64] |= uint64_t(1) << (y % 64);
+				m_upStops[x * m_columnWords + y / 64] |= uint64_t(1) << (y % 64);
+			}
+		}
+		for (size_t row = 1; row <= m_height; row++)
+		{
+			for (size_t w = 0; w < m_rowWords; w++)
+			{
+				const size_t i = row * m_rowWords + w;
+				TransposeWord(~m_free[i] | forcedDown[i] | goalPlane[i], row, w, m_downStops);
+				TransposeWord(~m_free[i] | forcedUp[i] | goalPlane[i], row, w, m_upStops);
+			}
+		}
+	}
+
+	bool IsFree(size_t row, size_t x) const { return (m_free[row * m_rowWords + x / 64] >> (x % 64)) & 1; }
+
+	// Точка прыжка из (row, x) в направлении direction или NO_BIT, если по пути только стена.
+	// Возвращает номер столбца для горизонтального хода и номер строки для вертикального
+	size_t Jump(size_t row, size_t x, Direction direction) const
+	{
+		size_t stop = NO_BIT;
+		switch (direction)
+		{
+		case RIGHT:
+			stop = FindNextBit(&m_rowStops[row * m_rowWords], m_rowWords, x + 1);
+			return stop < m_width && IsFree(row, stop) ? stop : NO_BIT;
+		case LEFT:
+			stop = x == 0 ? NO_BIT : FindPreviousBit(&m_rowStops[row * m_rowWords], x - 1);
+			return stop != NO_BIT && IsFree(row, stop) ? stop : NO_BIT;
+		case DOWN:
+			stop = FindNextBit(&m_downStops[x * m_columnWords], m_columnWords, row);
+			return stop < m_height && IsFree(stop + 1, x) ? stop + 1 : NO_BIT;
+		case UP:
+		default:
+			stop = row < 2 ? NO_BIT : FindPreviousBit(&m_upStops[x * m_columnWords], row - 2);
+			return stop != NO_BIT && IsFree(stop + 1, x) ? stop + 1 : NO_BIT;
+		}
+	}
+
+private:
+	// Бит x результата - клетка x - 1 строки row
+	uint64_t ShiftFromLeft(size_t row, size_t w) const
+	{
+		const uint64_t* words = &m_free[row * m_rowWords];
+		return (words[w] << 1) | (w > 0 ? words[w - 1] >> 63 : 0);
+	}
+
+	// Бит x результата - клетка x + 1 строки row
+	uint64_t ShiftFromRight(size_t row, size_t w) const
+	{
+		const uint64_t* words = &m_free[row * m_rowWords];
+		return (words[w] >> 1) | (w + 1 < m_rowWords ? words[w + 1] << 63 : 0);
+	}
+
+	void TransposeWord(uint64_t word, size_t row, size_t w, std::vector<uint64_t>& columns) const
+	{
+		const size_t y = row - 1;
+		while (word != 0)
+		{
+			const size_t x = w * 64 + std::countr_zero(word);
+			word &= word - 1;
+			if (x >= m_width)
+			{
+				break;
+			}
+			columns[x * m_columnWords + y / 64] |= uint64_t(1) << (y % 64);
+		}
+	}
+
+	size_t m_width;
+	size_t m_height;
+	size_t m_rowWords;
+	size_t m_columnWords;
+	std::vector<uint64_t> m_free;
+	std::vector<uint64_t> m_rowStops;
+	std::vector<uint64_t> m_downStops;
+	std::vector<uint64_t> m_upStops;
+};
+
+// Стоимость точки может уменьшиться уже после её прыжков, поэтому предыдущей точкой
+// считается первая клетка назад по направлению прихода, до которой путь не длиннее нужного
+Path RestoreJumpPath(const JumpCosts& costs, const DirectionMap& arrival, Position start, Position end)
+{
+	const auto offsets = GetDirectionOffsets(arrival.stride);
+	Path path = { end };
+	Position current = end;
+	uint32_t currentCost = GetCost(costs, end);
+	while (current != start)
+	{
+		const std::ptrdiff_t offset = offsets[arrival.Get(current)];
+		Position previous = current;
+		uint32_t previousCost = UNVISITED;
+		uint32_t steps = 0;
+		do
+		{
+			previous = static_cast<Position>(previous - offset);
+			steps++;
+			path.push_back(previous);
+			previousCost = GetCost(costs, previous);
+		} while (previousCost == UNVISITED || previousCost + steps > currentCost);
+		currentCost = previousCost;
+		current = previous;
+	}
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+} // namespace
+
+Path JumpPointSearch(const Labyrinth& labyrinth, SearchStats& stats)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+	const size_t stride = labyrinth.stride;
+	const JumpGrid grid(labyrinth, b);
+
+	JumpCosts costs;
+	DirectionMap arrival{ std::vector<uint8_t>(((labyrinth.height + 2) * stride + 3) / 4, 0), stride };
+
+	// Прыжок длины k меняет g на k, а эвристику не больше чем на k
+	BucketQueue queue(static_cast<uint32_t>(2 * (stride + labyrinth.height)));
+	const uint32_t startPriority = ManhattanDistance(a, b, stride);
+	queue.Reset(startPriority);
+	costs[a] = 0;
+	queue.Push(startPriority, a);
+
+	auto jumpFrom = [&](Position current, Direction direction) {
+		const size_t row = current / stride;
+		const size_t x = current % stride;
+		const size_t stop = grid.Jump(row, x, direction);
+		if (stop == NO_BIT)
+		{
+			return;
+		}
+		const Position next = static_cast<Position>(direction == LEFT || direction == RIGHT ? row * stride + stop : stop * stride + x);
+		const uint32_t nextCost = costs[current] + ManhattanDistance(current, next, stride);
+		auto [it, inserted] = costs.try_emplace(next, nextCost);
+		if (inserted || nextCost < it->second)
+		{
+			it->second = nextCost;
+			arrival.Set(next, direction);
+			queue.Push(nextCost + ManhattanDistance(next, b, stride), next);
+		}
+	};
+
+	while (!queue.Empty())
+	{
+		const Position current = queue.Pop();
+		if (costs[current] + ManhattanDistance(current, b, stride) != queue.CurrentKey())
+		{
+			continue;
+		}
+		stats.expanded++;
+
+		if (current == b)
+		{
+			return RestoreJumpPath(costs, arrival, a, b);
+		}
+
+		if (current == a)
+		{
+			for (Direction direction : { UP, DOWN, LEFT, RIGHT })
+			{
+				jumpFrom(current, direction);
+			}
+			continue;
+		}
+
+		const Direction direction = static_cast<Direction>(arrival.Get(current));
+		jumpFrom(current, direction);
+		if (direction == LEFT || direction == RIGHT)
+		{
+			jumpFrom(current, UP);
+			jumpFrom(current, DOWN);
+			continue;
+		}
+
+		// Вертикальный ход поворачивает только к вынужденным соседям
+		const size_t row = current / stride;
+		const size_t x = current % stride;
+		const size_t previousRow = direction == DOWN ? row - 1 : row + 1;
+		if (x > 0 && grid.IsFree(row, x - 1) && !grid.IsFree(previousRow, x - 1))
+		{
+			jumpFrom(current, LEFT);
+		}
+		if (grid.IsFree(row, x + 1) && !grid.IsFree(previousRow, x + 1))
+		{
+			jumpFrom(current, RIGHT);
+		}
+	}
+
+	throw std::runtime_error("Can't find path");
+}
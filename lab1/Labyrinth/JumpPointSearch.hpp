@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include "WaveAlgorithm.hpp"
+
+// Jump Point Search для 4-связной сетки с единичными рёбрами. Горизонтальный ход играет роль
+// диагонального в классическом JPS: из каждой его клетки проверяются вертикальные прыжки,
+// а вертикальный ход останавливается только на вынужденных соседях и цели.
+// Условия остановки заранее собраны в битовые плоскости строк и столбцов, поэтому прыжок -
+// поиск ближайшего единичного бита по словам. Длина пути совпадает с волной, сам путь может отличаться
+Path JumpPointSearch(const Labyrinth& labyrinth, SearchStats& stats);
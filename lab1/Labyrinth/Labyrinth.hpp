@@ -1,14 +1,52 @@
 #pragma once
 
-#include <vector>
-#include <string>
+#include "MappedFile.hpp"
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
 
-const std::string HELP_TEXT = "Usage: labyrinth <input file> <output file>\n"
+const std::string HELP_TEXT = "Usage: labyrinth [--stats] [--strategy <wave|bidirectional|astar|jps|bitwave|parallel|parents|weighted>] <input file> <output file>\n"
+							  "       labyrinth [--stats] --query <input file> [<cache size>]\n"
 							  "If u don't provide an input file, the program will read from stdin and out into stdout.\n"
+							  "--strategy selects the path search: breadth-first wave from 'A' (default), wave from both ends, A* search,\n"
+							  "Jump Point Search (fast on open labyrinths),\n"
+							  "bit-parallel wave, multithreaded wave or wave storing 2-bit parent directions instead of distances\n"
+							  "(all three give the same path as the default),\n"
+							  "or the cheapest path over terrain costs (weighted).\n"
+							  "--query loads the labyrinth once and answers \"<row A> <column A> <row B> <column B>\" lines (0-based) from stdin\n"
+							  "with the path length and \"row:column\" cells. Distance maps of the last <cache size> (default 8) starts are reused.\n"
 							  "Proggram works with labyrinths represented as a grid of characters. The program will find the shortest path from 'A' to 'B' and mark it with '.'.\n"
-							  "Maximum labyrinth size is 100x100. Allowed characters in labyrinth are: 'A', 'B', '#'. \n";
+							  "Labyrinth size is limited only by memory (up to 4 billion cells). Allowed characters in labyrinth are: 'A', 'B', '#', ' ' \n"
+							  "and digits '1'-'9' - terrain that costs the digit to enter (other cells cost 1, costs matter only for weighted).\n"
+							  "--stats prints phase timings, peak memory and allocation counts to stderr as JSON.\n";
+
+const char WALL = '#';
+// Дополняет короткие строки до общей ширины, считается стеной и не выводится
+const char PADDING = '\0';
+
+// Клетки адресуются 32-битными индексами, две строки зарезервированы под рамку карты расстояний
+const uint64_t MAX_CELLS = UINT32_MAX - 2;
+
+// Лабиринт - height строк по stride символов, каждая завершается '\n'.
+// Строки короче stride - 1 дополняются PADDING (padded == true).
+// Клетки лежат либо в buffer, либо прямо в отображённом в память файле
+struct Labyrinth
+{
+	Labyrinth() = default;
+	Labyrinth(Labyrinth&&) = default;
+	Labyrinth& operator=(Labyrinth&&) = default;
+	Labyrinth(const Labyrinth&) = delete;
+	Labyrinth& operator=(const Labyrinth&) = delete;
+
+	std::span<char> cells;
+	size_t stride = 0;
+	size_t height = 0;
+	bool padded = false;
 
-using Labyrinth = std::vector<std::vector<char>>;
-const int MAX_SIZE = 100;
\ No newline at end of file
+	std::vector<char> buffer;
+	std::unique_ptr<MappedFile> mapping;
+};
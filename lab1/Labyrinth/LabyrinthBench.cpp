@@ -0,0 +1,248 @@
+#include "LabyrinthIO.hpp"
+#include "ParallelWave.hpp"
+#include "PathSearch.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+const std::string HELP_TEXT_BENCH = "Usage: labyrinth-bench [--scaling] <input file>\n"
+									"       labyrinth-bench [--scaling] <width> <height> <wall percent> <count>\n"
+									"Runs every search strategy on the labyrinth (or on <count> random labyrinths),\n"
+									"checks that all of them find valid paths of the same length and reports expanded nodes and time.\n"
+									"With --scaling runs the multithreaded wave on 1, 2, 4, ... threads and reports the speedup.\n";
+
+struct StrategyTotals
+{
+	uint64_t expanded = 0;
+	double milliseconds = 0;
+};
+
+std::string GenerateLabyrinthText(size_t width, size_t height, int wallPercent, unsigned seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_int_distribution<int> percent(0, 99);
+	std::string text;
+	text.reserve((width + 1) * height);
+	for (size_t y = 0; y < height; y++)
+	{
+		for (size_t x = 0; x < width; x++)
+		{
+			text += percent(random) < wallPercent ? WALL : ' ';
+		}
+		text += '\n';
+	}
+
+	std::uniform_int_distribution<size_t> cell(0, width * height - 1);
+	size_t a = cell(random);
+	size_t b = cell(random);
+	if (a == b)
+	{
+		b = (b + 1) % (width * height);
+	}
+	text[a / width * (width + 1) + a % width] = 'A';
+	text[b / width * (width + 1) + b % width] = 'B';
+	return text;
+}
+
+bool IsValidPath(const Labyrinth& labyrinth, const Path& path)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+	RoadMap roadMap = CreateRoadMap(labyrinth);
+	if (path.empty() || path.front() != a || path.back() != b)
+	{
+		return false;
+	}
+	for (size_t i = 0; i < path.size(); i++)
+	{
+		if (roadMap.dist[path[i]] != UNVISITED)
+		{
+			return false;
+		}
+		if (i > 0)
+		{
+			uint32_t step = path[i] > path[i - 1] ? path[i] - path[i - 1] : path[i - 1] - path[i];
+			if (step != 1 && step != labyrinth.stride)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Возвращает false, если стратегии разошлись в длине пути или вернули некорректный путь
+bool BenchLabyrinth(const Labyrinth& labyrinth, std::vector<StrategyTotals>& totals)
+{
+	int64_t expectedLength = -2;
+	bool agreed = true;
+	for (size_t i = 0; i < SEARCH_STRATEGIES.size(); i++)
+	{
+		const auto& [name, strategy] = SEARCH_STRATEGIES[i];
+		SearchStats stats;
+		int64_t length = -1;
+
+		Path path;
+		auto start = std::chrono::steady_clock::now();
+		try
+		{
+			path = FindPath(labyrinth, strategy, stats);
+		}
+		catch (const std::runtime_error&)
+		{
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		if (!path.empty())
+		{
+			length = static_cast<int64_t>(path.size()) - 1;
+			if (!IsValidPath(labyrinth, path))
+			{
+				std::cerr << name << ": invalid path" << std::endl;
+				agreed = false;
+			}
+		}
+
+		totals[i].expanded += stats.expanded;
+		totals[i].milliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+
+		if (expectedLength == -2)
+		{
+			expectedLength = length;
+		}
+		else if (length != expectedLength)
+		{
+			std::cerr << name << ": path length " << length << ", expected " << expectedLength << std::endl;
+			agreed = false;
+		}
+	}
+	return agreed;
+}
+
+void PrintTotals(const std::vector<StrategyTotals>& totals, size_t count)
+{
+	std::cout << std::left << std::setw(16) << "strategy" << std::setw(16) << "expanded" << "time, ms" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < SEARCH_STRATEGIES.size(); i++)
+	{
+		std::cout << std::setw(16) << SEARCH_STRATEGIES[i].first
+				  << std::setw(16) << totals[i].expanded / count
+				  << totals[i].milliseconds / count << std::endl;
+	}
+}
+
+std::vector<unsigned> GetScalingThreadCounts()
+{
+	std::vector<unsigned> threadCounts;
+	for (unsigned threads = 1; threads < GetDefaultThreadCount(); threads *= 2)
+	{
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(GetDefaultThreadCount());
+	return threadCounts;
+}
+
+// Возвращает false, если при разном числе потоков получились разные расстояния до 'B'
+bool BenchScaling(const Labyrinth& labyrinth, const std::vector<unsigned>& threadCounts, std::vector<double>& milliseconds)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+	uint32_t expectedDist = 0;
+	for (size_t i = 0; i < threadCounts.size(); i++)
+	{
+		SearchStats stats;
+		auto start = std::chrono::steady_clock::now();
+		RoadMap roadMap = ParallelWaveAlgorithm(labyrinth, stats, threadCounts[i]);
+		auto end = std::chrono::steady_clock::now();
+		milliseconds[i] += std::chrono::duration<double, std::milli>(end - start).count();
+
+		if (i == 0)
+		{
+			expectedDist = roadMap.dist[b];
+		}
+		else if (roadMap.dist[b] != expectedDist)
+		{
+			std::cerr << threadCounts[i] << " threads: distance " << roadMap.dist[b] << ", expected " << expectedDist << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+void PrintScaling(const std::vector<unsigned>& threadCounts, const std::vector<double>& milliseconds, size_t count)
+{
+	std::cout << std::left << std::setw(16) << "threads" << std::setw(16) << "time, ms" << "speedup" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < threadCounts.size(); i++)
+	{
+		std::cout << std::setw(16) << threadCounts[i]
+				  << std::setw(16) << milliseconds[i] / count
+				  << milliseconds[0] / milliseconds[i] << std::endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> params(argv + 1, argv + argc);
+	bool scaling = !params.empty() && params[0] == "--scaling";
+	if (scaling)
+	{
+		params.erase(params.begin());
+	}
+	if (params.size() != 1 && params.size() != 4)
+	{
+		std::cout << HELP_TEXT_BENCH;
+		return 1;
+	}
+
+	std::vector<StrategyTotals> totals(SEARCH_STRATEGIES.size());
+	const std::vector<unsigned> threadCounts = GetScalingThreadCounts();
+	std::vector<double> milliseconds(threadCounts.size(), 0);
+	size_t count = 1;
+
+	std::function<bool(const Labyrinth&)> bench = [&](const Labyrinth& labyrinth) {
+		return scaling ? BenchScaling(labyrinth, threadCounts, milliseconds) : BenchLabyrinth(labyrinth, totals);
+	};
+	bool agreed = true;
+
+	try
+	{
+		if (params.size() == 1)
+		{
+			agreed = bench(MapLabyrinth(params[0]));
+		}
+		else
+		{
+			size_t width = std::stoul(params[0]);
+			size_t height = std::stoul(params[1]);
+			int wallPercent = std::stoi(params[2]);
+			count = std::max<size_t>(std::stoul(params[3]), 1);
+
+			for (unsigned seed = 1; seed <= count; seed++)
+			{
+				std::istringstream input(GenerateLabyrinthText(width, height, wallPercent, seed));
+				if (!bench(ReadLabyrinth(input)))
+				{
+					std::cerr << "Mismatch on random labyrinth with seed " << seed << std::endl;
+					agreed = false;
+				}
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl;
+		return 1;
+	}
+
+	if (scaling)
+	{
+		PrintScaling(threadCounts, milliseconds, count);
+	}
+	else
+	{
+		PrintTotals(totals, count);
+	}
+	return agreed ? 0 : 1;
+}
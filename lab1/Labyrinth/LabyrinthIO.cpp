@@ -0,0 +1,140 @@
+#include "LabyrinthIO.hpp"
+#include "BufferedIO.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+void ValidateLabyrinthSize(size_t stride, size_t height)
+{
+	if ((static_cast<uint64_t>(height) + 2) * stride > MAX_CELLS)
+	{
+		throw std::runtime_error("Labyrinth exceeds maximum allowed size of " + std::to_string(MAX_CELLS) + " cells");
+	}
+}
+
+// Длина строки вместе с '\n', если все строки одной длины и текст завершается '\n', иначе 0
+size_t GetUniformStride(const char* text, size_t size)
+{
+	const void* firstEnd = std::memchr(text, '\n', size);
+	if (firstEnd == nullptr)
+	{
+		return 0;
+	}
+	size_t stride = static_cast<const char*>(firstEnd) - text + 1;
+	if (size % stride != 0)
+	{
+		return 0;
+	}
+	for (size_t rowStart = stride; rowStart < size; rowStart += stride)
+	{
+		if (std::memchr(text + rowStart, '\n', stride) != text + rowStart + stride - 1)
+		{
+			return 0;
+		}
+	}
+	return stride;
+}
+
+// Раскладывает строки текста по выровненному буферу, как если бы они читались через std::getline
+void LayoutLabyrinth(Labyrinth& labyrinth, const char* text, size_t size)
+{
+	size_t width = 0;
+	size_t height = 0;
+	for (size_t pos = 0; pos < size; height++)
+	{
+		const void* found = std::memchr(text + pos, '\n', size - pos);
+		size_t lineEnd = found ? static_cast<const char*>(found) - text : size;
+		width = std::max(width, lineEnd - pos);
+		pos = lineEnd + 1;
+	}
+
+	labyrinth.stride = width + 1;
+	labyrinth.height = height;
+	ValidateLabyrinthSize(labyrinth.stride, labyrinth.height);
+	labyrinth.buffer.assign(labyrinth.stride * labyrinth.height, PADDING);
+
+	char* row = labyrinth.buffer.data();
+	for (size_t pos = 0; pos < size; row += labyrinth.stride)
+	{
+		const void* found = std::memchr(text + pos, '\n', size - pos);
+		size_t lineEnd = found ? static_cast<const char*>(found) - text : size;
+		std::memcpy(row, text + pos, lineEnd - pos);
+		labyrinth.padded = labyrinth.padded || lineEnd - pos != width;
+		row[width] = '\n';
+		pos = lineEnd + 1;
+	}
+	labyrinth.cells = labyrinth.buffer;
+}
+} // namespace
+
+Labyrinth ReadLabyrinth(std::istream& input)
+{
+	STATS_SCOPE("read");
+	std::vector<char> text = ReadAll(input);
+	STATS_BYTES("read", text.size());
+
+	Labyrinth labyrinth;
+	size_t stride = GetUniformStride(text.data(), text.size());
+	if (stride == 0)
+	{
+		LayoutLabyrinth(labyrinth, text.data(), text.size());
+		return labyrinth;
+	}
+
+	ValidateLabyrinthSize(stride, text.size() / stride);
+	labyrinth.stride = stride;
+	labyrinth.height = text.size() / stride;
+	labyrinth.buffer = std::move(text);
+	labyrinth.cells = labyrinth.buffer;
+	return labyrinth;
+}
+
+Labyrinth MapLabyrinth(const std::string& fileName)
+{
+	STATS_SCOPE("read");
+	auto mapping = std::make_unique<MappedFile>(fileName);
+	STATS_BYTES("read", mapping->Size());
+
+	Labyrinth labyrinth;
+	size_t stride = GetUniformStride(mapping->Data(), mapping->Size());
+	if (stride == 0)
+	{
+		LayoutLabyrinth(labyrinth, mapping->Data(), mapping->Size());
+		return labyrinth;
+	}
+
+	ValidateLabyrinthSize(stride, mapping->Size() / stride);
+	labyrinth.stride = stride;
+	labyrinth.height = mapping->Size() / stride;
+	labyrinth.cells = { mapping->Data(), mapping->Size() };
+	labyrinth.mapping = std::move(mapping);
+	return labyrinth;
+}
+
+void PrintLabyrinth(const Labyrinth& labyrinth, std::ostream& output)
+{
+	STATS_SCOPE("write");
+	if (!labyrinth.padded)
+	{
+		STATS_BYTES("write", labyrinth.cells.size());
+		output.write(labyrinth.cells.data(), static_cast<std::streamsize>(labyrinth.cells.size()));
+		output.flush();
+		return;
+	}
+
+	// Выравнивание вырезается на лету: куски строк между ним копятся в буфере вывода
+	BufferedWriter writer(output);
+	const char* pos = labyrinth.cells.data();
+	const char* end = pos + labyrinth.cells.size();
+	while (pos != end)
+	{
+		const char* padding = std::find(pos, end, PADDING);
+		writer.Write(std::string_view(pos, padding));
+		STATS_BYTES("write", padding - pos);
+		pos = std::find_if(padding, end, [](char cell) { return cell != PADDING; });
+	}
+	writer.Flush();
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include <iostream>
+#include <string>
+
+Labyrinth ReadLabyrinth(std::istream& input);
+
+// Отображает файл в память и использует его как сетку без копирования,
+// если все строки одной длины. Иначе строки копируются в выровненный буфер
+Labyrinth MapLabyrinth(const std::string& fileName);
+
+void PrintLabyrinth(const Labyrinth& labyrinth, std::ostream& output);
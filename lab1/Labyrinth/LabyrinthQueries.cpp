@@ -0,0 +1,92 @@
+#include "LabyrinthQueries.hpp"
+#include "RoadMapCache.hpp"
+#include "Stats.hpp"
+#include <sstream>
+#include <string>
+
+namespace
+{
+Position GetQueryPosition(const Labyrinth& labyrinth, size_t row, size_t column)
+{
+	if (row >= labyrinth.height || column + 1 >= labyrinth.stride)
+	{
+		return NO_POSITION;
+	}
+	char cell = labyrinth.cells[row * labyrinth.stride + column];
+	if (cell == WALL || cell == PADDING)
+	{
+		return NO_POSITION;
+	}
+	return static_cast<Position>((row + 1) * labyrinth.stride + column);
+}
+
+// Путь всегда восстанавливается по карте от начальной клетки, поэтому ответ не зависит
+// от того, какие ещё карты лежат в кэше, а повторные запросы из той же клетки стоят O(длины пути).
+// Карту от цели не используем: при нескольких кратчайших путях она дала бы другой путь
+Path FindQueryPath(RoadMapCache& cache, Position start, Position goal)
+{
+	const RoadMap& roadMap = cache.Get(start);
+	if (roadMap.dist[goal] == UNVISITED)
+	{
+		return {};
+	}
+	return RestorePath(roadMap, start, goal);
+}
+
+void PrintQueryPath(const Path& path, size_t stride, std::ostream& output)
+{
+	if (path.empty())
+	{
+		output << "no path\n";
+		return;
+	}
+	output << path.size() - 1;
+	for (Position pos : path)
+	{
+		output << ' ' << pos / stride - 1 << ':' << pos % stride;
+	}
+	output << '\n';
+}
+} // namespace
+
+void ProcessQueries(const Labyrinth& labyrinth, std::istream& input, std::ostream& output, size_t cacheSize)
+{
+	RoadMapCache cache(labyrinth, cacheSize);
+	std::string line;
+
+	while (std::getline(input, line))
+	{
+		if (line.find_first_not_of(" \t\r") == std::string::npos)
+		{
+			continue;
+		}
+
+		STATS_COUNT("queries", 1);
+		std::istringstream query(line);
+		size_t startRow, startColumn, goalRow, goalColumn;
+		Position start = NO_POSITION;
+		Position goal = NO_POSITION;
+		if (query >> startRow >> startColumn >> goalRow >> goalColumn)
+		{
+			start = GetQueryPosition(labyrinth, startRow, startColumn);
+			goal = GetQueryPosition(labyrinth, goalRow, goalColumn);
+		}
+
+		if (start == NO_POSITION || goal == NO_POSITION)
+		{
+			output << "invalid query\n";
+		}
+		else
+		{
+			PrintQueryPath(FindQueryPath(cache, start, goal), labyrinth.stride, output);
+		}
+
+		// Сбрасываем вывод, только когда запросы во входном буфере закончились
+		if (input.rdbuf()->in_avail() <= 0)
+		{
+			output.flush();
+		}
+	}
+	output.flush();
+	STATS_COUNT("road map misses", cache.Misses());
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include <iostream>
+
+const size_t DEFAULT_QUERY_CACHE_SIZE = 8;
+
+// Читает из input запросы "<строка A> <столбец A> <строка B> <столбец B>" (с нуля)
+// и для каждого выводит длину кратчайшего пути и его клетки "строка:столбец",
+// либо "no path" / "invalid query". Карты расстояний переиспользуются через RoadMapCache
+void ProcessQueries(const Labyrinth& labyrinth, std::istream& input, std::ostream& output, size_t cacheSize);
@@ -0,0 +1,153 @@
+#include "ParallelWave.hpp"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <exception>
+#include <thread>
+
+namespace
+{
+// Пока фронт меньше порога, слои дешевле расширять в одном потоке, чем синхронизировать потоки
+const size_t PARALLEL_FRONTIER_SIZE = 4096;
+
+struct WaveState
+{
+	std::vector<uint32_t>& dist;
+	std::array<std::ptrdiff_t, 4> offsets;
+	Position end;
+	std::vector<Position> frontier = {};
+	std::vector<std::vector<Position>> nextFrontiers = {};
+	std::vector<uint64_t> expanded = {};
+	bool done = false;
+	// Исключение из завершения слоя: барьер требует, чтобы оно само не бросало
+	std::exception_ptr error = nullptr;
+};
+
+void ExpandSerially(WaveState& state)
+{
+	std::vector<Position> next;
+	while (!state.frontier.empty() && state.frontier.size() < PARALLEL_FRONTIER_SIZE && state.dist[state.end] == UNVISITED)
+	{
+		next.clear();
+		for (Position current : state.frontier)
+		{
+			uint32_t nextDist = state.dist[current] + 1;
+			for (std::ptrdiff_t offset : state.offsets)
+			{
+				Position neighbor = static_cast<Position>(current + offset);
+				if (state.dist[neighbor] == UNVISITED)
+				{
+					state.dist[neighbor] = nextDist;
+					next.push_back(neighbor);
+				}
+			}
+		}
+		state.expanded[0] += state.frontier.size();
+		state.frontier.swap(next);
+	}
+	state.done = state.frontier.empty() || state.dist[state.end] != UNVISITED;
+}
+
+void ExpandChunk(WaveState& state, unsigned thread, unsigned threadCount)
+{
+	const size_t size = state.frontier.size();
+	const size_t begin = size * thread / threadCount;
+	const size_t end = size * (thread + 1) / threadCount;
+	std::vector<Position>& next = state.nextFrontiers[thread];
+
+	for (size_t i = begin; i < end; i++)
+	{
+		Position current = state.frontier[i];
+		uint32_t nextDist = state.dist[current] + 1;
+		for (std::ptrdiff_t offset : state.offsets)
+		{
+			Position neighbor = static_cast<Position>(current + offset);
+			std::atomic_ref<uint32_t> cell(state.dist[neighbor]);
+			uint32_t expected = UNVISITED;
+			if (cell.load(std::memory_order_relaxed) == UNVISITED
+				&& cell.compare_exchange_strong(expected, nextDist, std::memory_order_relaxed))
+			{
+				next.push_back(neighbor);
+			}
+		}
+	}
+	state.expanded[thread] += end - begin;
+}
+
+// Выполняется одним потоком, пока остальные ждут на барьере
+void MergeFrontiers(WaveState& state)
+{
+	state.frontier.clear();
+	for (auto& next : state.nextFrontiers)
+	{
+		state.frontier.insert(state.frontier.end(), next.begin(), next.end());
+		next.clear();
+	}
+	ExpandSerially(state);
+}
+
+// Нехватка памяти при слиянии фронтов останавливает волну, а исключение пробрасывается после барьера
+void CompleteLevel(WaveState& state) noexcept
+{
+	try
+	{
+		MergeFrontiers(state);
+	}
+	catch (...)
+	{
+		state.error = std::current_exception();
+		state.done = true;
+	}
+}
+} // namespace
+
+unsigned GetDefaultThreadCount()
+{
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+RoadMap ParallelWaveAlgorithm(const Labyrinth& labyrinth, SearchStats& stats, unsigned threadCount)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+	threadCount = std::max(threadCount, 1u);
+
+	RoadMap roadMap = CreateRoadMap(labyrinth);
+	WaveState state{ roadMap.dist, GetDirectionOffsets(labyrinth.stride), b };
+	state.nextFrontiers.resize(threadCount);
+	state.expanded.resize(threadCount, 0);
+
+	roadMap.dist[a] = 0;
+	state.frontier.push_back(a);
+	ExpandSerially(state);
+
+	if (!state.done)
+	{
+		auto onLevelCompleted = [&state]() noexcept { CompleteLevel(state); };
+		std::barrier levelBarrier(threadCount, onLevelCompleted);
+
+		auto worker = [&](unsigned thread) {
+			while (!state.done)
+			{
+				ExpandChunk(state, thread, threadCount);
+				levelBarrier.arrive_and_wait();
+			}
+		};
+
+		std::vector<std::jthread> threads;
+		for (unsigned thread = 1; thread < threadCount; thread++)
+		{
+			threads.emplace_back(worker, thread);
+		}
+		worker(0);
+	}
+	if (state.error)
+	{
+		std::rethrow_exception(state.error);
+	}
+
+	for (uint64_t expanded : state.expanded)
+	{
+		stats.expanded += expanded;
+	}
+	return roadMap;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include "WaveAlgorithm.hpp"
+
+// Волна по слоям на нескольких потоках: фронт делится между потоками поровну, клетка захватывается
+// атомарным compare-and-swap в карте расстояний, а новые клетки копятся в буфере своего потока
+// и сливаются в общий фронт на барьере. Расстояния совпадают с WaveAlgorithm,
+// поэтому RestorePath даёт тот же путь независимо от числа потоков
+RoadMap ParallelWaveAlgorithm(const Labyrinth& labyrinth, SearchStats& stats, unsigned threadCount);
+
+unsigned GetDefaultThreadCount();
@@ -0,0 +1,101 @@
+#include "ParentWave.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+std::array<std::ptrdiff_t, 4> GetRestoreOffsets(size_t stride)
+{
+	auto offsets = GetDirectionOffsets(stride);
+	std::reverse(offsets.begin(), offsets.end());
+	return offsets;
+}
+
+class VisitedSet
+{
+public:
+	// Стены, дополнение, '\n' и строки рамки сразу считаются посещёнными
+	explicit VisitedSet(const Labyrinth& labyrinth)
+		: m_bits(((labyrinth.height + 2) * labyrinth.stride + 63) / 64, ~uint64_t(0))
+	{
+		for (size_t i = 0; i < labyrinth.cells.size(); i++)
+		{
+			char cell = labyrinth.cells[i];
+			if (cell != WALL && cell != PADDING && cell != '\n')
+			{
+				Position pos = static_cast<Position>(i + labyrinth.stride);
+				m_bits[pos / 64] &= ~(uint64_t(1) << (pos % 64));
+			}
+		}
+	}
+
+	bool Test(Position pos) const { return (m_bits[pos / 64] >> (pos % 64)) & 1; }
+
+	void Set(Position pos) { m_bits[pos / 64] |= uint64_t(1) << (pos % 64); }
+
+private:
+	std::vector<uint64_t> m_bits;
+};
+} // namespace
+
+DirectionMap ParentWaveAlgorithm(const Labyrinth& labyrinth, const Position& a, const Position& b, SearchStats& stats)
+{
+	DirectionMap directionMap{ std::vector<uint8_t>(((labyrinth.height + 2) * labyrinth.stride + 3) / 4, 0), labyrinth.stride };
+	VisitedSet visited(labyrinth);
+	const auto restoreOffsets = GetRestoreOffsets(labyrinth.stride);
+
+	std::vector<Position> frontier{ a };
+	std::vector<Position> next;
+	visited.Set(a);
+
+	while (!frontier.empty() && !visited.Test(b))
+	{
+		next.clear();
+		// Родитель лежит в направлении restoreOffsets[direction] от клетки, поэтому открываем её шагом в обратную сторону
+		for (uint8_t direction = 0; direction < restoreOffsets.size(); direction++)
+		{
+			std::ptrdiff_t step = -restoreOffsets[direction];
+			for (Position current : frontier)
+			{
+				Position neighbor = static_cast<Position>(current + step);
+				if (!visited.Test(neighbor))
+				{
+					visited.Set(neighbor);
+					directionMap.Set(neighbor, direction);
+					next.push_back(neighbor);
+				}
+			}
+		}
+		stats.expanded += frontier.size();
+		frontier.swap(next);
+	}
+
+	if (!visited.Test(b))
+	{
+		throw std::runtime_error("Can't find path");
+	}
+	return directionMap;
+}
+
+Path RestorePathByDirections(const DirectionMap& directionMap, const Position& start, const Position& end)
+{
+	const auto restoreOffsets = GetRestoreOffsets(directionMap.stride);
+	Path path;
+	Position current = end;
+
+	while (current != start)
+	{
+		path.push_back(current);
+		current = static_cast<Position>(current + restoreOffsets[directionMap.Get(current)]);
+	}
+	path.push_back(start);
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+Path ParentWaveSearch(const Labyrinth& labyrinth, SearchStats& stats)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+	DirectionMap directionMap = ParentWaveAlgorithm(labyrinth, a, b, stats);
+	return RestorePathByDirections(directionMap, a, b);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include "WaveAlgorithm.hpp"
+
+// Направление на родителя: индекс в порядке обхода соседей RestorePath (вправо, влево, вниз, вверх).
+// Четыре клетки по два бита в байте, адресация как у RoadMap
+struct DirectionMap
+{
+	std::vector<uint8_t> directions;
+	size_t stride = 0;
+
+	uint8_t Get(Position pos) const { return (directions[pos / 4] >> (pos % 4 * 2)) & 3; }
+
+	void Set(Position pos, uint8_t direction)
+	{
+		const unsigned shift = pos % 4 * 2;
+		directions[pos / 4] = static_cast<uint8_t>((directions[pos / 4] & ~(3u << shift)) | (direction << shift));
+	}
+};
+
+// Волна, запоминающая для каждой клетки не расстояние, а направление на родителя.
+// Слой расширяется по направлениям в порядке приоритета RestorePath, поэтому первый, кто
+// открыл клетку, и есть сосед, которого выбрал бы RestorePath. Во время волны дополнительно
+// нужен бит посещения на клетку - 3 бита вместо 32
+DirectionMap ParentWaveAlgorithm(const Labyrinth& labyrinth, const Position& start, const Position& end, SearchStats& stats);
+
+// Путь по направлениям - прямой проход от end к start без перебора соседей
+Path RestorePathByDirections(const DirectionMap& directionMap, const Position& start, const Position& end);
+
+Path ParentWaveSearch(const Labyrinth& labyrinth, SearchStats& stats);
@@ -0,0 +1,58 @@
+#include "PathSearch.hpp"
+#include "AStarSearch.hpp"
+#include "BidirectionalSearch.hpp"
+#include "BitWave.hpp"
+#include "JumpPointSearch.hpp"
+#include "ParallelWave.hpp"
+#include "ParentWave.hpp"
+#include "WeightedSearch.hpp"
+#include <stdexcept>
+
+SearchStrategy ParseSearchStrategy(const std::string& name)
+{
+	for (const auto& [strategyName, strategy] : SEARCH_STRATEGIES)
+	{
+		if (strategyName == name)
+		{
+			return strategy;
+		}
+	}
+	throw std::invalid_argument("Unknown search strategy " + name);
+}
+
+namespace
+{
+Path RestorePathFromStart(const Labyrinth& labyrinth, const RoadMap& roadMap)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+	if (roadMap.dist[b] == UNVISITED)
+	{
+		throw std::runtime_error("Can't find path");
+	}
+	return RestorePath(roadMap, a, b);
+}
+} // namespace
+
+Path FindPath(const Labyrinth& labyrinth, SearchStrategy strategy, SearchStats& stats)
+{
+	switch (strategy)
+	{
+	case SearchStrategy::BIDIRECTIONAL:
+		return BidirectionalSearch(labyrinth, stats);
+	case SearchStrategy::ASTAR:
+		return AStarSearch(labyrinth, stats);
+	case SearchStrategy::JPS:
+		return JumpPointSearch(labyrinth, stats);
+	case SearchStrategy::BITWAVE:
+		return BitWaveSearch(labyrinth, stats);
+	case SearchStrategy::PARALLEL:
+		return RestorePathFromStart(labyrinth, ParallelWaveAlgorithm(labyrinth, stats, GetDefaultThreadCount()));
+	case SearchStrategy::PARENTS:
+		return ParentWaveSearch(labyrinth, stats);
+	case SearchStrategy::WEIGHTED:
+		return WeightedSearch(labyrinth, stats);
+	case SearchStrategy::WAVE:
+	default:
+		return RestorePathFromStart(labyrinth, WaveAlgorithm(labyrinth, stats));
+	}
+}
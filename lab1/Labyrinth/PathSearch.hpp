@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include "WaveAlgorithm.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class SearchStrategy
+{
+	WAVE,
+	BIDIRECTIONAL,
+	ASTAR,
+	JPS,
+	BITWAVE,
+	PARALLEL,
+	PARENTS,
+	WEIGHTED,
+};
+
+const std::vector<std::pair<std::string, SearchStrategy>> SEARCH_STRATEGIES = {
+	{ "wave", SearchStrategy::WAVE },
+	{ "bidirectional", SearchStrategy::BIDIRECTIONAL },
+	{ "astar", SearchStrategy::ASTAR },
+	{ "jps", SearchStrategy::JPS },
+	{ "bitwave", SearchStrategy::BITWAVE },
+	{ "parallel", SearchStrategy::PARALLEL },
+	{ "parents", SearchStrategy::PARENTS },
+	{ "weighted", SearchStrategy::WEIGHTED },
+};
+
+SearchStrategy ParseSearchStrategy(const std::string& name);
+
+// Кратчайший путь от 'A' до 'B' выбранной стратегией. Длина пути не зависит от стратегии,
+// но при нескольких кратчайших путях разные стратегии могут выбрать разные.
+// WEIGHTED ищет путь минимальной стоимости местности и совпадает с остальными, только если цифр в лабиринте нет
+Path FindPath(const Labyrinth& labyrinth, SearchStrategy strategy, SearchStats& stats);
@@ -0,0 +1,39 @@
+#include "RoadMapCache.hpp"
+#include <algorithm>
+
+RoadMapCache::RoadMapCache(const Labyrinth& labyrinth, size_t capacity)
+	: m_labyrinth(labyrinth)
+	, m_capacity(std::max<size_t>(capacity, 1))
+{
+}
+
+const RoadMap* RoadMapCache::Find(Position start)
+{
+	auto it = m_index.find(start);
+	if (it == m_index.end())
+	{
+		return nullptr;
+	}
+	m_entries.splice(m_entries.begin(), m_entries, it->second);
+	return &it->second->second;
+}
+
+const RoadMap& RoadMapCache::Get(Position start)
+{
+	if (const RoadMap* cached = Find(start))
+	{
+		return *cached;
+	}
+
+	m_misses++;
+	if (m_entries.size() == m_capacity)
+	{
+		m_index.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+
+	SearchStats stats;
+	m_entries.emplace_front(start, WaveAlgorithm(m_labyrinth, start, NO_POSITION, stats));
+	m_index[start] = m_entries.begin();
+	return m_entries.front().second;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include "WaveAlgorithm.hpp"
+#include <list>
+#include <unordered_map>
+
+// LRU-кэш карт расстояний, построенных волной из заданной клетки по всему лабиринту.
+// Повторный запрос из той же клетки отвечается по готовой карте за длину пути
+class RoadMapCache
+{
+public:
+	RoadMapCache(const Labyrinth& labyrinth, size_t capacity);
+
+	// Карта расстояний от start, если она уже есть в кэше, иначе nullptr
+	const RoadMap* Find(Position start);
+
+	// Карта расстояний от start. При отсутствии строит её и вытесняет самую давно использованную
+	const RoadMap& Get(Position start);
+
+	uint64_t Misses() const { return m_misses; }
+
+private:
+	using Entry = std::pair<Position, RoadMap>;
+
+	const Labyrinth& m_labyrinth;
+	size_t m_capacity;
+	std::list<Entry> m_entries;
+	std::unordered_map<Position, std::list<Entry>::iterator> m_index;
+	uint64_t m_misses = 0;
+};
@@ -1,112 +1,138 @@
 #include "WaveAlgorithm.hpp"
+#include "FrontierQueue.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+std::array<std::ptrdiff_t, 4> GetDirectionOffsets(size_t stride)
+{
+	std::array<std::ptrdiff_t, 4> offsets{};
+	for (size_t i = 0; i < DIRECTIONS.size(); i++)
+	{
+		offsets[i] = DIRECTIONS[i].first * static_cast<std::ptrdiff_t>(stride) + DIRECTIONS[i].second;
+	}
+	return offsets;
+}
 
 Position GetCharPosition(const Labyrinth& labyrinth, const char& ch)
 {
-	for (size_t y = 0; y < labyrinth.size(); y++)
+	const void* found = std::memchr(labyrinth.cells.data(), ch, labyrinth.cells.size());
+	if (found == nullptr)
+	{
+		return NO_POSITION;
+	}
+	return static_cast<Position>(static_cast<const char*>(found) - labyrinth.cells.data() + labyrinth.stride);
+}
+
+RoadMap CreateRoadMap(const Labyrinth& labyrinth)
+{
+	RoadMap roadMap{ std::vector<uint32_t>((labyrinth.height + 2) * labyrinth.stride, BLOCKED), labyrinth.stride };
+
+	for (size_t i = 0; i < labyrinth.cells.size(); i++)
 	{
-		for (size_t x = 0; x < labyrinth[y].size(); x++)
+		char cell = labyrinth.cells[i];
+		if (cell != WALL && cell != PADDING && cell != '\n')
 		{
-			if (labyrinth[y][x] == ch)
-			{
-				return { static_cast<int>(y), static_cast<int>(x) };
-			}
+			roadMap.dist[i + labyrinth.stride] = UNVISITED;
 		}
 	}
-	return { -1, -1 };
+	return roadMap;
 }
 
-RoadMap WaveAlgorithm(const Labyrinth& labyrinth)
+std::pair<Position, Position> GetEndpoints(const Labyrinth& labyrinth)
 {
 	Position a = GetCharPosition(labyrinth, 'A');
 	Position b = GetCharPosition(labyrinth, 'B');
 
-	if (a.first == -1 || a.second == -1)
+	if (a == NO_POSITION)
 	{
 		throw std::runtime_error("Start position 'A' not found");
 	}
-	if (b.first == -1 || b.second == -1)
+	if (b == NO_POSITION)
 	{
 		throw std::runtime_error("End position 'B' not found");
 	}
-
-	RoadMap dist;
-
-	for (size_t y = 0; y < labyrinth.size(); y++)
+	if ((static_cast<uint64_t>(labyrinth.height) + 2) * labyrinth.stride > MAX_CELLS)
 	{
-		std::vector<int> row;
-		for (size_t x = 0; x < labyrinth[y].size(); x++)
-		{
-			row.push_back(-1);
-		}
-		dist.push_back(row);
+		throw std::runtime_error("Labyrinth is too large");
 	}
+	return { a, b };
+}
+
+RoadMap WaveAlgorithm(const Labyrinth& labyrinth)
+{
+	SearchStats stats;
+	return WaveAlgorithm(labyrinth, stats);
+}
+
+RoadMap WaveAlgorithm(const Labyrinth& labyrinth, SearchStats& stats)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+	return WaveAlgorithm(labyrinth, a, b, stats);
+}
+
+RoadMap WaveAlgorithm(const Labyrinth& labyrinth, const Position& a, const Position& b, SearchStats& stats)
+{
+	STATS_SCOPE("wave");
+	RoadMap roadMap = CreateRoadMap(labyrinth);
+	std::vector<uint32_t>& dist = roadMap.dist;
+	const auto offsets = GetDirectionOffsets(labyrinth.stride);
 
-	std::queue<std::pair<int, int>> queue;
+	FrontierQueue queue(2 * (labyrinth.stride + labyrinth.height));
 
-	dist[a.first][a.second] = 0;
-	queue.push(a);
+	dist[a] = 0;
+	queue.Push(a);
 
-	while (!queue.empty())
+	while (!queue.Empty())
 	{
-		auto current = queue.front();
-		queue.pop();
+		Position current = queue.Pop();
+		stats.expanded++;
 
 		if (current == b)
 			break;
 
-		for (const auto& dir : DIRECTIONS)
+		uint32_t nextDist = dist[current] + 1;
+		for (std::ptrdiff_t offset : offsets)
 		{
-			int newY = current.first + dir.first;
-			int newX = current.second + dir.second;
-
-			if (newY < 0 || newY >= static_cast<int>(labyrinth.size())
-				|| newX < 0 || newX >= static_cast<int>(labyrinth[newY].size()))
-			{
-				continue;
-			}
-
-			if (labyrinth[newY][newX] != '#' && dist[newY][newX] == -1)
+			Position next = static_cast<Position>(current + offset);
+			if (dist[next] == UNVISITED)
 			{
-				dist[newY][newX] = dist[current.first][current.second] + 1;
-				queue.push({ newY, newX });
+				dist[next] = nextDist;
+				queue.Push(next);
 			}
 		}
 	}
-	return dist;
+	return roadMap;
 }
 
-std::vector<std::pair<int, int>> RestorePath(const RoadMap& dist, const Position& start, const Position& end)
-
+Path RestorePath(const RoadMap& roadMap, const Position& start, const Position& end)
 {
-	std::vector<std::pair<int, int>> path;
+	const std::vector<uint32_t>& dist = roadMap.dist;
+	Path path;
 	Position current = end;
-	int currentDist = dist[current.first][current.second];
+	uint32_t currentDist = dist[current];
 
-	if (currentDist == -1)
+	if (currentDist == UNVISITED || currentDist == BLOCKED)
 	{
 		throw std::runtime_error("No path exists between A and B");
 	}
 
-	std::vector<std::pair<int, int>> restoreDirections(DIRECTIONS.rbegin(), DIRECTIONS.rend());
+	const auto offsets = GetDirectionOffsets(roadMap.stride);
+	std::vector<std::ptrdiff_t> restoreDirections(offsets.rbegin(), offsets.rend());
 
+	path.reserve(currentDist + 1);
 	while (current != start)
 	{
 		bool found = false;
-		for (const auto& dir : restoreDirections)
+		for (std::ptrdiff_t offset : restoreDirections)
 		{
-			int newY = current.first + dir.first;
-			int newX = current.second + dir.second;
-
-			if (newY < 0 || newY >= static_cast<int>(dist.size())
-				|| newX < 0 || newX >= static_cast<int>(dist[newY].size()))
-			{
-				continue;
-			}
+			Position next = static_cast<Position>(current + offset);
 
-			if (dist[newY][newX] == currentDist - 1)
+			if (dist[next] == currentDist - 1)
 			{
 				path.push_back(current);
-				current = { newY, newX };
+				current = next;
 				currentDist--;
 				found = true;
 				break;
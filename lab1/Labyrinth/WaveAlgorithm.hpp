@@ -1,15 +1,48 @@
 #pragma once
 
 #include "Labyrinth.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
-#include <queue>
 
-using RoadMap = std::vector<std::vector<int>>;
-using Position = std::pair<int, int>;
+// Позиция - индекс клетки в RoadMap::dist (индекс в Labyrinth::cells + stride)
+using Position = uint32_t;
+using Path = std::vector<Position>;
+
+const uint32_t UNVISITED = UINT32_MAX;
+const uint32_t BLOCKED = UINT32_MAX - 1;
+const Position NO_POSITION = UINT32_MAX;
+
 const std::vector<std::pair<int, int>> DIRECTIONS = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
 
+// Расстояния от старта по всем клеткам лабиринта. Сверху и снизу добавлено по строке BLOCKED,
+// слева и справа стенами служат позиции '\n', поэтому соседей можно брать без проверки границ
+struct RoadMap
+{
+	std::vector<uint32_t> dist;
+	size_t stride = 0;
+};
+
+struct SearchStats
+{
+	uint64_t expanded = 0;
+};
+
+std::array<std::ptrdiff_t, 4> GetDirectionOffsets(size_t stride);
+
 Position GetCharPosition(const Labyrinth& labyrinth, const char& ch);
 
-std::vector<std::pair<int, int>> RestorePath(const RoadMap& dist, const Position& start, const Position& end);
+// Позиции 'A' и 'B'. Бросает исключение, если одной из них нет или лабиринт слишком велик
+std::pair<Position, Position> GetEndpoints(const Labyrinth& labyrinth);
+
+RoadMap CreateRoadMap(const Labyrinth& labyrinth);
+
+Path RestorePath(const RoadMap& roadMap, const Position& start, const Position& end);
 
 RoadMap WaveAlgorithm(const Labyrinth& labyrinth);
+
+RoadMap WaveAlgorithm(const Labyrinth& labyrinth, SearchStats& stats);
+
+// Волна из start до извлечения end. При end == NO_POSITION заполняется вся достижимая область
+RoadMap WaveAlgorithm(const Labyrinth& labyrinth, const Position& start, const Position& end, SearchStats& stats);
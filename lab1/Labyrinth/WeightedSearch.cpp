@@ -0,0 +1,125 @@
+#include "WeightedSearch.hpp"
+#include "BucketQueue.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+uint32_t GetPositionCost(const Labyrinth& labyrinth, Position pos)
+{
+	return GetTerrainCost(labyrinth.cells[pos - labyrinth.stride]);
+}
+} // namespace
+
+uint32_t GetTerrainCost(char cell)
+{
+	if (cell >= '1' && cell <= '9')
+	{
+		return static_cast<uint32_t>(cell - '0');
+	}
+	return 1;
+}
+
+RoadMap WeightedWaveAlgorithm(const Labyrinth& labyrinth, SearchStats& stats)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+	// Стоимость любого пути должна помещаться в dist, не задевая UNVISITED и BLOCKED
+	if (labyrinth.cells.size() >= BLOCKED / MAX_TERRAIN_COST)
+	{
+		throw std::runtime_error("Labyrinth is too large for weighted search");
+	}
+
+	RoadMap roadMap = CreateRoadMap(labyrinth);
+	std::vector<uint32_t>& dist = roadMap.dist;
+	const auto offsets = GetDirectionOffsets(labyrinth.stride);
+
+	BucketQueue queue(MAX_TERRAIN_COST);
+	queue.Reset(0);
+
+	dist[a] = 0;
+	queue.Push(0, a);
+
+	while (!queue.Empty())
+	{
+		Position current = queue.Pop();
+
+		// Устаревшая запись: клетка уже была извлечена с меньшей стоимостью
+		if (dist[current] != queue.CurrentKey())
+		{
+			continue;
+		}
+		stats.expanded++;
+
+		if (current == b)
+		{
+			break;
+		}
+
+		for (std::ptrdiff_t offset : offsets)
+		{
+			Position next = static_cast<Position>(current + offset);
+			if (dist[next] == BLOCKED)
+			{
+				continue;
+			}
+			uint32_t nextDist = dist[current] + GetPositionCost(labyrinth, next);
+			if (nextDist < dist[next])
+			{
+				dist[next] = nextDist;
+				queue.Push(nextDist, next);
+			}
+		}
+	}
+	return roadMap;
+}
+
+Path RestoreWeightedPath(const Labyrinth& labyrinth, const RoadMap& roadMap, const Position& start, const Position& end)
+{
+	const std::vector<uint32_t>& dist = roadMap.dist;
+	Path path;
+	Position current = end;
+
+	if (dist[current] == UNVISITED || dist[current] == BLOCKED)
+	{
+		throw std::runtime_error("No path exists between A and B");
+	}
+
+	const auto offsets = GetDirectionOffsets(roadMap.stride);
+	std::vector<std::ptrdiff_t> restoreDirections(offsets.rbegin(), offsets.rend());
+
+	while (current != start)
+	{
+		uint32_t previousDist = dist[current] - GetPositionCost(labyrinth, current);
+		bool found = false;
+		for (std::ptrdiff_t offset : restoreDirections)
+		{
+			Position next = static_cast<Position>(current + offset);
+
+			if (dist[next] == previousDist)
+			{
+				path.push_back(current);
+				current = next;
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+		{
+			throw std::runtime_error("Path restoration failed");
+		}
+	}
+	path.push_back(start);
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+Path WeightedSearch(const Labyrinth& labyrinth, SearchStats& stats)
+{
+	auto [a, b] = GetEndpoints(labyrinth);
+	RoadMap roadMap = WeightedWaveAlgorithm(labyrinth, stats);
+	if (roadMap.dist[b] == UNVISITED)
+	{
+		throw std::runtime_error("Can't find path");
+	}
+	return RestoreWeightedPath(labyrinth, roadMap, a, b);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Labyrinth.hpp"
+#include "WaveAlgorithm.hpp"
+
+// Цифры '1'..'9' - клетки местности, вход в которые стоит столько же, сколько цифра.
+// Вход в любую другую проходимую клетку стоит 1
+const uint32_t MAX_TERRAIN_COST = 9;
+
+uint32_t GetTerrainCost(char cell);
+
+// Дейкстра по стоимости местности. Стоимости - небольшие целые, поэтому вместо кучи
+// используется BucketQueue на MAX_TERRAIN_COST + 1 корзин (алгоритм Дайла)
+RoadMap WeightedWaveAlgorithm(const Labyrinth& labyrinth, SearchStats& stats);
+
+// Восстанавливает путь минимальной стоимости по карте WeightedWaveAlgorithm,
+// перебирая соседей в том же порядке, что и RestorePath
+Path RestoreWeightedPath(const Labyrinth& labyrinth, const RoadMap& roadMap, const Position& start, const Position& end);
+
+Path WeightedSearch(const Labyrinth& labyrinth, SearchStats& stats);
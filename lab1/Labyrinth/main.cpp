@@ -1,57 +1,24 @@
 #include "Labyrinth.hpp"
-#include "WaveAlgorithm.hpp"
+#include "LabyrinthIO.hpp"
+#include "LabyrinthQueries.hpp"
+#include "PathSearch.hpp"
+#include "Stats.hpp"
 
-Labyrinth ReadLabyrinth(std::istream& input)
+void ProcessLabyrinth(Labyrinth& labyrinth, SearchStrategy strategy)
 {
-	Labyrinth labyrinth;
-	std::string line;
-
-	while (std::getline(input, line) && labyrinth.size() < MAX_SIZE)
-	{
-		if (line.size() > MAX_SIZE)
-		{
-			throw std::runtime_error("Labyrinth row exceeds maximum allowed size of " + std::to_string(MAX_SIZE));
-		}
-		labyrinth.push_back(std::vector<char>(line.begin(), line.end()));
-	}
-	if (labyrinth.size() > MAX_SIZE)
+	SearchStats stats;
+	Path path;
 	{
-		throw std::runtime_error("Labyrinth exceeds maximum allowed size of " + std::to_string(MAX_SIZE) + " rows");
+		STATS_SCOPE("search");
+		path = FindPath(labyrinth, strategy, stats);
 	}
-
-	return labyrinth;
-}
-
-void PrintLabyrinth(const Labyrinth& labyrinth, std::ostream& output)
-{
-	for (const auto& row : labyrinth)
-	{
-		for (const auto& cell : row)
-		{
-			output << cell;
-		}
-		output << std::endl;
-	}
-}
-
-void ProcessLabyrinth(Labyrinth& labyrinth)
-{
-
-	RoadMap dist = WaveAlgorithm(labyrinth);
-	Position a = GetCharPosition(labyrinth, 'A');
-	Position b = GetCharPosition(labyrinth, 'B');
-
-	if (dist[b.first][b.second] == -1)
-	{
-		throw std::runtime_error("Can't find path");
-	}
-
-	std::vector<std::pair<int, int>> path = RestorePath(dist, a, b);
-	for (const auto& pos : path)
+	STATS_COUNT("expanded cells", stats.expanded);
+	for (Position pos : path)
 	{
-		if (labyrinth[pos.first][pos.second] == ' ')
+		char& cell = labyrinth.cells[pos - labyrinth.stride];
+		if (cell == ' ' || (cell >= '1' && cell <= '9'))
 		{
-			labyrinth[pos.first][pos.second] = '.';
+			cell = '.';
 		}
 	}
 }
@@ -61,6 +28,7 @@ enum class ProgrammMode
 	HELP,
 	FILE,
 	STDIN,
+	QUERY,
 	INVALID
 };
 
@@ -70,37 +38,66 @@ struct ProgrammArgs
 	int modeBasedErrorCode;
 	std::string inputFile;
 	std::string outputFile;
+	SearchStrategy strategy = SearchStrategy::WAVE;
+	size_t cacheSize = DEFAULT_QUERY_CACHE_SIZE;
 };
 
 ProgrammArgs ParseProgrammArgs(int argc, char* argv[])
 {
-	if (argc == 2 && std::string(argv[1]) == "-h")
+	std::vector<std::string> params(argv + 1, argv + argc);
+
+	if (params.size() == 1 && params[0] == "-h")
 	{
 		return { ProgrammMode::HELP };
 	}
 
-	if (argc == 3)
+	if ((params.size() == 2 || params.size() == 3) && params[0] == "--query")
 	{
-		return { ProgrammMode::FILE, 0, argv[1], argv[2] };
+		ProgrammArgs args{ ProgrammMode::QUERY, 1, params[1] };
+		if (params.size() == 3)
+		{
+			try
+			{
+				args.cacheSize = std::stoul(params[2]);
+			}
+			catch (const std::exception&)
+			{
+				return { ProgrammMode::INVALID };
+			}
+		}
+		return args;
 	}
-	if (argc == 1)
+
+	SearchStrategy strategy = SearchStrategy::WAVE;
+	if (params.size() >= 2 && params[0] == "--strategy")
+	{
+		try
+		{
+			strategy = ParseSearchStrategy(params[1]);
+		}
+		catch (const std::invalid_argument&)
+		{
+			return { ProgrammMode::INVALID };
+		}
+		params.erase(params.begin(), params.begin() + 2);
+	}
+
+	if (params.size() == 2)
 	{
-		return { ProgrammMode::STDIN, 1 };
+		return { ProgrammMode::FILE, 0, params[0], params[1], strategy };
+	}
+	if (params.empty())
+	{
+		return { ProgrammMode::STDIN, 1, "", "", strategy };
 	}
 	return { ProgrammMode::INVALID };
 }
 
 void ProcessFileMode(const ProgrammArgs& args)
 {
-	std::ifstream inputFile(args.inputFile);
-	if (!inputFile.is_open())
-	{
-		throw std::runtime_error("Can't open file " + args.inputFile);
-	}
-
-	Labyrinth labyrinth = ReadLabyrinth(inputFile);
-	ProcessLabyrinth(labyrinth);
-	std::ofstream outputFile(args.outputFile);
+	Labyrinth labyrinth = MapLabyrinth(args.inputFile);
+	ProcessLabyrinth(labyrinth, args.strategy);
+	std::ofstream outputFile(args.outputFile, std::ios::binary);
 	if (!outputFile.is_open())
 	{
 		throw std::runtime_error("Can't open file " + args.outputFile);
@@ -111,12 +108,19 @@ void ProcessFileMode(const ProgrammArgs& args)
 void ProcessUserInputMode(const ProgrammArgs& args)
 {
 	Labyrinth labyrinth = ReadLabyrinth(std::cin);
-	ProcessLabyrinth(labyrinth);
+	ProcessLabyrinth(labyrinth, args.strategy);
 	PrintLabyrinth(labyrinth, std::cout);
 }
 
+void ProcessQueryMode(const ProgrammArgs& args)
+{
+	Labyrinth labyrinth = MapLabyrinth(args.inputFile);
+	ProcessQueries(labyrinth, std::cin, std::cout, args.cacheSize);
+}
+
 int main(int argc, char* argv[])
 {
+	StatsReport stats(argc, argv);
 	auto args = ParseProgrammArgs(argc, argv);
 
 	if (args.mode == ProgrammMode::HELP)
@@ -141,6 +145,10 @@ int main(int argc, char* argv[])
 		{
 			ProcessUserInputMode(args);
 		}
+		else if (args.mode == ProgrammMode::QUERY)
+		{
+			ProcessQueryMode(args);
+		}
 	}
 	catch (const std::exception& e)
 	{
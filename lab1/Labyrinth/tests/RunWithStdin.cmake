@@ -0,0 +1,11 @@
+# Запускает COMMAND_PATH с аргументами COMMAND_ARGS, подавая INPUT_FILE на stdin и записывая stdout в OUTPUT_FILE
+separate_arguments(COMMAND_ARGS)
+execute_process(
+    COMMAND ${COMMAND_PATH} ${COMMAND_ARGS}
+    INPUT_FILE ${INPUT_FILE}
+    OUTPUT_FILE ${OUTPUT_FILE}
+    RESULT_VARIABLE RESULT
+)
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "${COMMAND_PATH} exited with ${RESULT}")
+endif()
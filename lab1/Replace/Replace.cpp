@@ -1,16 +1,25 @@
+#include "BufferedIO.hpp"
+#include "MappedFile.hpp"
+#include "Stats.hpp"
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <stdio.h>
 #include <string>
+#include <string_view>
 
 std::string ReplaceString(const std::string& subject,
 	const std::string& searchString, const std::string& replacementString)
 {
+	STATS_SCOPE("replace");
+	STATS_BYTES("replace", subject.length());
 	if (searchString.empty())
 	{
 		return subject;
 	}
 	size_t pos = 0;
+	[[maybe_unused]] uint64_t replacements = 0;
 
 	std::string result;
 	while (pos < subject.length())
@@ -21,6 +30,7 @@ std::string ReplaceString(const std::string& subject,
 			result.append(subject, pos, foundPos - pos);
 			result.append(replacementString);
 			pos = foundPos + searchString.length();
+			replacements++;
 		}
 		else
 		{
@@ -28,67 +38,79 @@ std::string ReplaceString(const std::string& subject,
 			break;
 		}
 	}
+	STATS_COUNT("replacements", replacements);
 	return result;
 }
 
-void CopyStreamWithReplacement(std::istream& input, std::ostream& output,
+// Все вхождения одной длины, поэтому замена самых левых непересекающихся вхождений
+// даёт то же, что и посимвольное сравнение хвоста прочитанного текста с искомой строкой
+void CopyTextWithReplacement(std::string_view text, BufferedWriter& output,
 	const std::string& searchString, const std::string& replacementString)
 {
+	// Заполненный буфер вывода сбрасывается посреди замены, поэтому эта фаза включает и часть записи
+	STATS_SCOPE("replace");
+	STATS_BYTES("replace", text.size());
 	if (searchString.empty())
 	{
-		output << input.rdbuf();
+		output.Write(text);
 		return;
 	}
 
-	std::string buffer;
-	char c;
-
-	while (input.get(c))
+	size_t pos = 0;
+	[[maybe_unused]] uint64_t replacements = 0;
+	for (size_t foundPos = text.find(searchString); foundPos != std::string_view::npos; foundPos = text.find(searchString, pos))
 	{
-		buffer += c;
-
-		if (buffer.size() >= searchString.size() && buffer.substr(buffer.size() - searchString.size()) == searchString)
-		{
-			buffer.erase(buffer.size() - searchString.size());
-			output << buffer << replacementString;
-			buffer.clear();
-		}
+		output.Write(text.substr(pos, foundPos - pos));
+		output.Write(replacementString);
+		pos = foundPos + searchString.length();
+		replacements++;
 	}
-
-	output << buffer;
+	output.Write(text.substr(pos));
+	STATS_COUNT("replacements", replacements);
 }
 
+// Входной файл отображается в память и просматривается целиком, вывод копится в большом буфере
 int CopyFileWithReplacement(const std::string& inputFilename, const std::string& outputFilename,
 	const std::string& search, const std::string& replace)
 {
-	std::ifstream inputFile;
-	inputFile.open(inputFilename);
-	if (!inputFile.is_open())
+	std::unique_ptr<MappedFile> inputFile;
+	try
+	{
+		STATS_SCOPE("read");
+		inputFile = std::make_unique<MappedFile>(inputFilename);
+		STATS_BYTES("read", inputFile->Size());
+	}
+	catch (const std::exception&)
 	{
 		std::cerr << "Can't open input file" << std::endl;
 		return 1;
 	}
 	std::ofstream outputFile;
-	outputFile.open(outputFilename);
+	outputFile.open(outputFilename, std::ios::binary);
 	if (!outputFile.is_open())
 	{
 		std::cerr << "Can't open output file" << std::endl;
 		return 1;
 	}
-	CopyStreamWithReplacement(inputFile, outputFile, search, replace);
-	outputFile.flush();
+	BufferedWriter output(outputFile);
+	CopyTextWithReplacement(std::string_view(inputFile->Data(), inputFile->Size()), output, search, replace);
+
+	STATS_SCOPE("write");
+	output.Flush();
+	STATS_BYTES("write", static_cast<uint64_t>(outputFile.tellp()));
 	return 0;
 }
 
 bool ReadInput(std::string& searchString, std::string& replacementString, std::string& subject)
 {
-	if (!std::getline(std::cin, searchString) || !std::getline(std::cin, replacementString))
+	BufferedReader input(std::cin);
+	if (!input.ReadLine(searchString) || !input.ReadLine(replacementString))
 	{
 		return false;
 	}
 
 	std::string line;
-	while (std::getline(std::cin, line))
+	while (input.ReadLine(line))
 	{
 		if (!subject.empty())
 		{
@@ -141,27 +163,40 @@ int ProcessUserInput()
 {
 	std::string searchString, replacementString, subject;
 
-	if (!ReadInput(searchString, replacementString, subject))
 	{
-		std::cerr << "ERROR" << std::endl;
-		return 1;
+		STATS_SCOPE("read");
+		if (!ReadInput(searchString, replacementString, subject))
+		{
+			std::cerr << "ERROR" << std::endl;
+			return 1;
+		}
+		STATS_BYTES("read", subject.size());
 	}
 
-	std::cout << "Result: " << std::endl
-			  << ReplaceString(subject, searchString, replacementString) << std::endl;
+	std::string result = ReplaceString(subject, searchString, replacementString);
+
+	STATS_SCOPE("write");
+	STATS_BYTES("write", result.size());
+	BufferedWriter output(std::cout);
+	output.Write("Result: \n");
+	output.Write(result);
+	output.Put('\n');
+	output.Flush();
 
 	return 0;
 }
 
 int main(int argc, char* argv[])
 {
+	StatsReport stats(argc, argv);
 	ProgrammArgs args = ParseArguments(argc, argv);
 
 	switch (args.mode)
 	{
 	case ProgrammMode::HELP:
-		std::cout << "Usage: replace <inputFile> <outputFile> <searchString> <replacementString>" << std::endl
-				  << "Replaces all occurrences of <searchString> with <replacementString> in <inputFile>." << std::endl;
+		std::cout << "Usage: replace [--stats] <inputFile> <outputFile> <searchString> <replacementString>" << std::endl
+				  << "Replaces all occurrences of <searchString> with <replacementString> in <inputFile>." << std::endl
+				  << "With --stats prints phase timings, peak memory and allocation counts to stderr as JSON." << std::endl;
 		return 0;
 	case ProgrammMode::FILE: {
 		int result = CopyFileWithReplacement(args.inputFile, args.outputFile, args.searchString, args.replacementString);
@@ -177,7 +212,7 @@ int main(int argc, char* argv[])
 	case ProgrammMode::INVALID:
 	default:
 		std::cout << "Invalid arguments. Use -h for help." << std::endl
-				  << "Usage: replace <inputFile> <outputFile> <searchString> <replacementString>" << std::endl;
+				  << "Usage: replace [--stats] <inputFile> <outputFile> <searchString> <replacementString>" << std::endl;
 		return 1;
 	}
 
@@ -1,62 +1,288 @@
 #include "HtmlDecode.hpp"
-#include <unordered_map>
+#include "HtmlEntities.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
 
-// " (двойная кавычка) заменяется на &quot;
-// ' (апостроф) заменяется на &apos;
-// < (знак меньше) заменяется на &lt;
-// > (знак больше) заменяется на &gt;
-// & (амперсанд) заменяется на &amp;
+// Декодируются все именованные сущности HTML5 (&quot; &apos; &lt; &gt; &amp; &copy; &NotEqualTilde; ...)
+// и числовые ссылки &#NNN; и &#xHH;. Без завершающей ';' ссылка остаётся как есть
 
 namespace DecodeConfig
 {
-const int maxEntityLength = 6;
-const std::unordered_map<std::string, char> entityMap = {
-	{ "&quot", '"' },
-	{ "&apos", '\'' },
-	{ "&lt", '<' },
-	{ "&gt", '>' },
-	{ "&amp", '&' }
-};
+// Имя или число между '&' и ';'; более длинные последовательности не ищутся
+const size_t maxEntityLength = MAX_ENTITY_NAME_LENGTH;
 }; // namespace DecodeConfig
 
-std::string HtmlDecode(std::string const& html)
+namespace
 {
-	std::string result;
-	std::string currentEntity;
-	for (char ch : html)
+const uint32_t MAX_CODE_POINT = 0x10FFFF;
+
+size_t DecodeNumericReference(std::string_view digits, char* buffer)
+{
+	uint32_t base = 10;
+	if (!digits.empty() && (digits[0] == 'x' || digits[0] == 'X'))
+	{
+		base = 16;
+		digits.remove_prefix(1);
+	}
+	if (digits.empty())
+	{
+		return 0;
+	}
+
+	uint32_t codePoint = 0;
+	for (char ch : digits)
+	{
+		uint32_t digit;
+		if (ch >= '0' && ch <= '9')
+		{
+			digit = ch - '0';
+		}
+		else if (base == 16 && ch >= 'a' && ch <= 'f')
+		{
+			digit = ch - 'a' + 10;
+		}
+		else if (base == 16 && ch >= 'A' && ch <= 'F')
+		{
+			digit = ch - 'A' + 10;
+		}
+		else
+		{
+			return 0;
+		}
+		// Дальше недопустимого кода считать не нужно, он всё равно заменится на U+FFFD
+		codePoint = std::min(codePoint * base + digit, MAX_CODE_POINT + 1);
+	}
+	return EncodeCharacterReference(codePoint, buffer);
+}
+
+// Ссылка у конца блока, ';' для которой может прийти в следующем блоке
+const size_t INCOMPLETE_ENTITY = SIZE_MAX;
+
+// Длина ссылки "&...;", начинающейся с позиции begin, или 0, если это не ссылка.
+// Внутри ссылки не может быть второго '&'. Текст ссылки возвращается в decoded,
+// для числовых ссылок он записывается в buffer. Если данные кончились раньше, чем стало ясно,
+// ссылка ли это, возвращает INCOMPLETE_ENTITY
+size_t MatchEntity(const char* begin, const char* end, std::string_view& decoded, char* buffer)
+{
+	const char* limit = begin + 1 + DecodeConfig::maxEntityLength;
+	for (const char* it = begin + 1; it <= limit; it++)
 	{
-		if (ch == '&')
+		if (it == end)
+		{
+			return INCOMPLETE_ENTITY;
+		}
+		if (*it == '&')
 		{
-			if (!currentEntity.empty()) result += currentEntity;
-			currentEntity = "&";
+			return 0;
 		}
-		else if (ch == ';' && !currentEntity.empty())
+		if (*it == ';')
 		{
-			auto it = DecodeConfig::entityMap.find(currentEntity);
-			if (it != DecodeConfig::entityMap.end())
+			std::string_view name(begin + 1, it - begin - 1);
+			if (!name.empty() && name[0] == '#')
 			{
-				result += it->second;
+				decoded = std::string_view(buffer, DecodeNumericReference(name.substr(1), buffer));
 			}
 			else
 			{
-				result += currentEntity + ch;
+				decoded = FindHtmlEntity(name);
 			}
-			currentEntity.clear();
+			return decoded.empty() ? 0 : it - begin + 1;
 		}
-		else if (currentEntity.length() > DecodeConfig::maxEntityLength)
+	}
+	return 0;
+}
+
+// Приёмники DecodeBlock: Copy переносит текст без изменений, Write пишет текст ссылки,
+// занимавшей исходные байты до sourceEnd, и возвращает false, если записать его нельзя
+struct StringOutput
+{
+	std::string& text;
+
+	void Copy(const char* first, const char* last) { text.append(first, last); }
+
+	bool Write(std::string_view decoded, const char*)
+	{
+		text += decoded;
+		return true;
+	}
+};
+
+// Отдельный буфер, не пересекающийся с входом
+struct BufferOutput
+{
+	char* pos;
+
+	void Copy(const char* first, const char* last)
+	{
+		std::memcpy(pos, first, last - first);
+		pos += last - first;
+	}
+
+	bool Write(std::string_view decoded, const char*)
+	{
+		std::memcpy(pos, decoded.data(), decoded.size());
+		pos += decoded.size();
+		return true;
+	}
+};
+
+// Запись поверх ещё не прочитанного входа: позиция записи никогда не обгоняет позицию чтения.
+// Только &nGt; и &nLt; длиннее своей записи, и им может не хватить места
+struct InPlaceOutput
+{
+	char* pos;
+
+	void Copy(const char* first, const char* last)
+	{
+		std::memmove(pos, first, last - first);
+		pos += last - first;
+	}
+
+	bool Write(std::string_view decoded, const char* sourceEnd)
+	{
+		if (pos + decoded.size() > sourceEnd)
+		{
+			return false;
+		}
+		std::memcpy(pos, decoded.data(), decoded.size());
+		pos += decoded.size();
+		return true;
+	}
+};
+
+// Декодирует [begin, end) в output и возвращает, сколько байт обработано.
+// Незавершённая ссылка в конце блока остаётся необработанной, если блок не последний.
+// Обработка также останавливается перед ссылкой, которую output не смог записать
+template <typename Output>
+size_t DecodeBlock(const char* begin, const char* end, bool last, Output& output)
+{
+	const char* current = begin;
+	// Текст между '&' копируется целиком, а разбор сущностей идёт только с найденных memchr позиций
+	while (current < end)
+	{
+		const char* amp = static_cast<const char*>(std::memchr(current, '&', end - current));
+		if (amp == nullptr)
 		{
-			result += currentEntity + ch;
-			currentEntity.clear();
+			output.Copy(current, end);
+			return end - begin;
 		}
-		else if (!currentEntity.empty())
+		output.Copy(current, amp);
+
+		std::string_view decoded;
+		char buffer[4];
+		size_t length = MatchEntity(amp, end, decoded, buffer);
+		if (length == INCOMPLETE_ENTITY && !last)
 		{
-			currentEntity += ch;
+			return amp - begin;
+		}
+		if (length != 0 && length != INCOMPLETE_ENTITY)
+		{
+			if (!output.Write(decoded, amp + length))
+			{
+				return amp - begin;
+			}
+			current = amp + length;
 		}
 		else
 		{
-			result += ch;
+			output.Copy(amp, amp + 1);
+			current = amp + 1;
 		}
 	}
-    result += currentEntity; 
+	return end - begin;
+}
+} // namespace
+
+std::string HtmlDecode(std::string const& html)
+{
+	std::string result;
+	result.reserve(html.size());
+	StringOutput output{ result };
+	DecodeBlock(html.data(), html.data() + html.size(), true, output);
 	return result;
-}
\ No newline at end of file
+}
+
+size_t HtmlDecodeInPlace(std::string& html)
+{
+	InPlaceOutput output{ html.data() };
+	const size_t processed = DecodeBlock(html.data(), html.data() + html.size(), true, output);
+	size_t written = output.pos - html.data();
+
+	// Растущей ссылке не хватило места: остаток сдвигается вправо на наибольший возможный прирост,
+	// после чего запись уже не догонит чтение. Строка удлиняется только в этом случае
+	if (processed < html.size())
+	{
+		const size_t restSize = html.size() - processed;
+		const size_t gap = GetMaxDecodedSize(restSize) - restSize;
+		html.resize(html.size() + gap);
+		std::memmove(html.data() + processed + gap, html.data() + processed, restSize);
+
+		InPlaceOutput restOutput{ html.data() + written };
+		DecodeBlock(html.data() + processed + gap, html.data() + html.size(), true, restOutput);
+		written = restOutput.pos - html.data();
+	}
+
+	html.resize(written);
+	return written;
+}
+
+size_t HtmlDecodeInto(std::string_view html, char* out)
+{
+	BufferOutput output{ out };
+	DecodeBlock(html.data(), html.data() + html.size(), true, output);
+	return output.pos - out;
+}
+
+HtmlDecoder::HtmlDecoder(HtmlSink sink)
+	: m_sink(std::move(sink))
+{
+}
+
+void HtmlDecoder::Feed(std::span<const char> chunk)
+{
+	const char* begin = chunk.data();
+	const char* end = chunk.data() + chunk.size();
+
+	// Хвост прошлого блока короче самой длинной ссылки, поэтому к нему достаточно
+	// добавить столько же байт нового блока, чтобы решить, ссылка ли это
+	if (!m_pending.empty())
+	{
+		const size_t pendingSize = m_pending.size();
+		const size_t taken = std::min(chunk.size(), MAX_PENDING_SIZE);
+		m_pending.append(begin, taken);
+		StringOutput output{ m_output };
+		const size_t decoded = DecodeBlock(m_pending.data(), m_pending.data() + m_pending.size(), false, output);
+		if (decoded < pendingSize)
+		{
+			m_pending.erase(0, decoded);
+			Flush();
+			return;
+		}
+		begin += decoded - pendingSize;
+		m_pending.clear();
+	}
+
+	m_output.reserve(end - begin);
+	StringOutput output{ m_output };
+	begin += DecodeBlock(begin, end, false, output);
+	m_pending.assign(begin, end);
+	Flush();
+}
+
+void HtmlDecoder::Finish()
+{
+	StringOutput output{ m_output };
+	DecodeBlock(m_pending.data(), m_pending.data() + m_pending.size(), true, output);
+	m_pending.clear();
+	Flush();
+}
+
+void HtmlDecoder::Flush()
+{
+	if (!m_output.empty())
+	{
+		m_sink(m_output);
+		m_output.clear();
+	}
+}
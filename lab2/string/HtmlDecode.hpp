@@ -1,5 +1,50 @@
 #pragma once
 
+#include "HtmlEntities.hpp"
+#include <cstddef>
+#include <functional>
+#include <span>
 #include <string>
+#include <string_view>
 
-std::string HtmlDecode(std::string const& html);
\ No newline at end of file
+std::string HtmlDecode(std::string const& html);
+
+// Декодированный текст не длиннее исходного, кроме &nGt; и &nLt; (5 байт превращаются в 6)
+constexpr size_t GetMaxDecodedSize(size_t htmlSize)
+{
+	return htmlSize + htmlSize / 5;
+}
+
+// Декодирует html на месте и возвращает новую длину строки. Память выделяется,
+// только если &nGt; или &nLt; не помещаются на место уже сжатого текста
+size_t HtmlDecodeInPlace(std::string& html);
+
+// Пишет декодированный html в out и возвращает его длину. В out должно быть
+// не меньше GetMaxDecodedSize(html.size()) байт, и он не должен пересекаться с html
+size_t HtmlDecodeInto(std::string_view html, char* out);
+
+using HtmlSink = std::function<void(std::string_view)>;
+
+// Потоковый декодер: текст подаётся блоками любой длины, ссылка может быть разрезана между ними.
+// Склеенный вывод в sink совпадает с HtmlDecode от склеенного ввода. Между блоками хранится
+// только незавершённая ссылка, поэтому память не зависит от размера документа
+class HtmlDecoder
+{
+public:
+	explicit HtmlDecoder(HtmlSink sink);
+
+	void Feed(std::span<const char> chunk);
+
+	// Выводит незавершённую ссылку в конце текста как есть
+	void Finish();
+
+private:
+	// '&', имя самой длинной сущности и ';'
+	static constexpr size_t MAX_PENDING_SIZE = MAX_ENTITY_NAME_LENGTH + 2;
+
+	void Flush();
+
+	HtmlSink m_sink;
+	std::string m_pending;
+	std::string m_output;
+};
@@ -0,0 +1,193 @@
+#include "HtmlDecode.hpp"
+#include "HtmlEncode.hpp"
+#include "HtmlEntities.hpp"
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+const std::string HELP_TEXT_BENCH = "Usage: html-decode-bench [<lookups>]\n"
+									"Compares entity lookup through the perfect hash with std::unordered_map<std::string, ...>\n"
+									"keyed by a freshly built std::string (the previous implementation)\n"
+									"and measures HtmlDecode and HtmlDecodeInPlace throughput.\n"
+									"HtmlEncode is compared with a char-by-char encoder on prose and on markup.\n";
+
+const size_t DEFAULT_LOOKUP_COUNT = 10'000'000;
+
+double MeasureMilliseconds(const std::function<void()>& action)
+{
+	auto start = std::chrono::steady_clock::now();
+	action();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Имена сущностей вперемешку с неизвестными, как они встречаются в тексте
+std::vector<std::string_view> GenerateLookupNames(size_t count)
+{
+	static const std::vector<std::string_view> unknownNames = { "abcdef", "nbspx", "Amp", "x", "quo" };
+	const auto entities = GetHtmlEntities();
+	std::mt19937 random(42);
+	std::uniform_int_distribution<size_t> entity(0, entities.size() - 1);
+	std::uniform_int_distribution<size_t> unknown(0, unknownNames.size() - 1);
+	std::uniform_int_distribution<int> percent(0, 99);
+
+	std::vector<std::string_view> names;
+	names.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		names.push_back(percent(random) < 90 ? entities[entity(random)].name : unknownNames[unknown(random)]);
+	}
+	return names;
+}
+
+std::string GenerateEntityText(size_t size)
+{
+	const auto entities = GetHtmlEntities();
+	std::mt19937 random(7);
+	std::uniform_int_distribution<size_t> entity(0, entities.size() - 1);
+	std::string text;
+	text.reserve(size + 64);
+	while (text.size() < size)
+	{
+		text += "word &";
+		text += entities[entity(random)].name;
+		text += "; &#";
+		text += std::to_string(random() % 0x3000);
+		text += "; ";
+	}
+	return text;
+}
+
+// Посимвольное кодирование с дописыванием в строку - то, что заменяет HtmlEncode
+std::string EncodeByChar(const std::string& text)
+{
+	std::string result;
+	for (char ch : text)
+	{
+		switch (ch)
+		{
+		case '"':
+			result += "&quot;";
+			break;
+		case '\'':
+			result += "&apos;";
+			break;
+		case '<':
+			result += "&lt;";
+			break;
+		case '>':
+			result += "&gt;";
+			break;
+		case '&':
+			result += "&amp;";
+			break;
+		default:
+			result += ch;
+		}
+	}
+	return result;
+}
+
+std::string RepeatText(const std::string& sample, size_t size)
+{
+	std::string text;
+	text.reserve(size + sample.size());
+	while (text.size() < size)
+	{
+		text += sample;
+	}
+	return text;
+}
+
+// Возвращает false, если HtmlEncode разошёлся с посимвольным кодированием
+bool BenchEncode(const std::string& name, const std::string& text)
+{
+	std::string byChar;
+	std::string encoded;
+	double byCharTime = MeasureMilliseconds([&]() { byChar = EncodeByChar(text); });
+	double encodeTime = MeasureMilliseconds([&]() { encoded = HtmlEncode(text); });
+	if (byChar != encoded)
+	{
+		std::cerr << "HtmlEncode disagrees with char-by-char encoding on " << name << std::endl;
+		return false;
+	}
+	std::cout << "HtmlEncode on " << name << ": " << text.size() / 1e3 / encodeTime << " MB/s, char by char "
+			  << text.size() / 1e3 / byCharTime << " MB/s" << std::endl;
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t lookupCount = DEFAULT_LOOKUP_COUNT;
+	if (argc == 2)
+	{
+		try
+		{
+			lookupCount = std::stoul(argv[1]);
+		}
+		catch (const std::exception&)
+		{
+			std::cout << HELP_TEXT_BENCH;
+			return 1;
+		}
+	}
+	else if (argc > 2)
+	{
+		std::cout << HELP_TEXT_BENCH;
+		return 1;
+	}
+
+	std::unordered_map<std::string, std::string_view> entityMap;
+	for (const HtmlEntity& entity : GetHtmlEntities())
+	{
+		entityMap.emplace("&" + std::string(entity.name), entity.text);
+	}
+
+	const auto names = GenerateLookupNames(lookupCount);
+	size_t hashFound = 0;
+	size_t mapFound = 0;
+	double hashTime = MeasureMilliseconds([&]() {
+		for (std::string_view name : names)
+		{
+			hashFound += FindHtmlEntity(name).size();
+		}
+	});
+	double mapTime = MeasureMilliseconds([&]() {
+		for (std::string_view name : names)
+		{
+			std::string currentEntity = "&" + std::string(name);
+			auto it = entityMap.find(currentEntity);
+			mapFound += it == entityMap.end() ? 0 : it->second.size();
+		}
+	});
+	if (hashFound != mapFound)
+	{
+		std::cerr << "Lookups disagree" << std::endl;
+		return 1;
+	}
+
+	const std::string text = GenerateEntityText(lookupCount * 4);
+	size_t decodedSize = 0;
+	double decodeTime = MeasureMilliseconds([&]() { decodedSize = HtmlDecode(text).size(); });
+	std::string inPlaceText = text;
+	double inPlaceTime = MeasureMilliseconds([&]() { HtmlDecodeInPlace(inPlaceText); });
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "perfect hash:  " << hashTime * 1e6 / lookupCount << " ns/lookup" << std::endl;
+	std::cout << "unordered_map: " << mapTime * 1e6 / lookupCount << " ns/lookup" << std::endl;
+	std::cout << "HtmlDecode:    " << text.size() / 1e3 / decodeTime << " MB/s on entity-dense text ("
+			  << text.size() << " -> " << decodedSize << " bytes)" << std::endl;
+	std::cout << "in place:      " << text.size() / 1e3 / inPlaceTime << " MB/s" << std::endl;
+
+	const std::string prose = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt "
+							  "ut labore et dolore magna aliqua. It's \"quoted\" & done.\n";
+	const std::string markup = "<div class=\"row\"><a href='/item?id=1&sort=asc'>Item</a></div>\n";
+	bool agreed = BenchEncode("prose", RepeatText(prose, lookupCount * 4));
+	agreed = BenchEncode("markup", RepeatText(markup, lookupCount * 4)) && agreed;
+	return agreed ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include "HtmlDecodeParallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Границы блоков: каждый, кроме последнего, заканчивается '\n'
+std::vector<size_t> SplitIntoBlocks(std::string_view html, size_t blockSize)
+{
+	std::vector<size_t> bounds = { 0 };
+	size_t begin = 0;
+	while (html.size() - begin > blockSize)
+	{
+		const void* newline = std::memchr(html.data() + begin + blockSize, '\n', html.size() - begin - blockSize);
+		if (newline == nullptr)
+		{
+			break;
+		}
+		begin = static_cast<const char*>(newline) - html.data() + 1;
+		bounds.push_back(begin);
+	}
+	if (bounds.back() != html.size())
+	{
+		bounds.push_back(html.size());
+	}
+	return bounds;
+}
+
+struct DecodedBlock
+{
+	std::vector<char> text;
+	size_t size = 0;
+	bool ready = false;
+};
+
+// Потоки берут блоки по порядку и декодируют в кольцо слотов, а вызывающий поток
+// отдаёт их в sink по порядку. Блок i ждёт, пока sink не освободит его слот после блока i - slots
+class ParallelDecoder
+{
+public:
+	ParallelDecoder(std::string_view html, std::vector<size_t> bounds, size_t slotCount)
+		: m_html(html)
+		, m_bounds(std::move(bounds))
+		, m_slots(slotCount)
+	{
+	}
+
+	void DecodeBlocks()
+	{
+		for (size_t block = m_nextBlock++; block + 1 < m_bounds.size(); block = m_nextBlock++)
+		{
+			DecodedBlock& slot = m_slots[block % m_slots.size()];
+			{
+				std::unique_lock lock(m_mutex);
+				m_changed.wait(lock, [&]() { return block < m_written + m_slots.size(); });
+			}
+
+			std::string_view text = m_html.substr(m_bounds[block], m_bounds[block + 1] - m_bounds[block]);
+			slot.text.resize(std::max(slot.text.size(), GetMaxDecodedSize(text.size())));
+			slot.size = HtmlDecodeInto(text, slot.text.data());
+
+			std::lock_guard lock(m_mutex);
+			slot.ready = true;
+			m_changed.notify_all();
+		}
+	}
+
+	void WriteBlocks(const HtmlSink& sink)
+	{
+		for (size_t block = 0; block + 1 < m_bounds.size(); block++)
+		{
+			DecodedBlock& slot = m_slots[block % m_slots.size()];
+			{
+				std::unique_lock lock(m_mutex);
+				m_changed.wait(lock, [&]() { return slot.ready; });
+			}
+
+			sink(std::string_view(slot.text.data(), slot.size));
+
+			std::lock_guard lock(m_mutex);
+			slot.ready = false;
+			m_written++;
+			m_changed.notify_all();
+		}
+	}
+
+private:
+	std::string_view m_html;
+	std::vector<size_t> m_bounds;
+	std::vector<DecodedBlock> m_slots;
+	std::atomic<size_t> m_nextBlock = 0;
+	size_t m_written = 0;
+	std::mutex m_mutex;
+	std::condition_variable m_changed;
+};
+} // namespace
+
+unsigned GetDefaultThreadCount()
+{
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void HtmlDecodeParallel(std::string_view html, const HtmlSink& sink, unsigned threadCount, size_t blockSize)
+{
+	threadCount = std::max(threadCount, 1u);
+	ParallelDecoder decoder(html, SplitIntoBlocks(html, std::max<size_t>(blockSize, 1)), 2 * threadCount);
+
+	std::vector<std::jthread> threads;
+	for (unsigned thread = 0; thread < threadCount; thread++)
+	{
+		threads.emplace_back([&decoder]() { decoder.DecodeBlocks(); });
+	}
+	decoder.WriteBlocks(sink);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "HtmlDecode.hpp"
+#include <cstddef>
+#include <string_view>
+
+const size_t DEFAULT_PARALLEL_BLOCK_SIZE = 4 << 20;
+
+unsigned GetDefaultThreadCount();
+
+// Делит текст на блоки примерно по blockSize байт, заканчивающиеся переводом строки,
+// и декодирует их на threadCount потоках. Ссылка не может содержать '\n', поэтому блоки
+// независимы, и вывод в sink по порядку блоков совпадает с HtmlDecoder побайтно.
+// В памяти одновременно не больше 2 * threadCount декодированных блоков
+void HtmlDecodeParallel(std::string_view html, const HtmlSink& sink, unsigned threadCount,
+	size_t blockSize = DEFAULT_PARALLEL_BLOCK_SIZE);
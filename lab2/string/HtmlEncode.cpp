@@ -0,0 +1,128 @@
+#include "HtmlEncode.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HTML_ENCODE_SSE2
+#endif
+
+namespace
+{
+struct EncodeTable
+{
+	std::array<uint8_t, 256> extra{};
+	std::array<std::string_view, 256> entity{};
+};
+
+// Сколько байт добавляет замена символа и на что он заменяется
+constexpr EncodeTable CreateEncodeTable()
+{
+	EncodeTable table;
+	const std::pair<unsigned char, std::string_view> entities[] = {
+		{ '"', "&quot;" },
+		{ '\'', "&apos;" },
+		{ '<', "&lt;" },
+		{ '>', "&gt;" },
+		{ '&', "&amp;" },
+	};
+	for (const auto& [ch, entity] : entities)
+	{
+		table.entity[ch] = entity;
+		table.extra[ch] = static_cast<uint8_t>(entity.size() - 1);
+	}
+	return table;
+}
+
+constexpr EncodeTable ENCODE_TABLE = CreateEncodeTable();
+
+#ifdef HTML_ENCODE_SSE2
+const size_t BLOCK_SIZE = 16;
+
+struct BlockMasks
+{
+	uint32_t quotes;
+	uint32_t angles;
+	uint32_t amps;
+};
+
+// Битовые маски символов блока по классам с одинаковой длиной замены: " и ' (+5), < и > (+3), & (+4)
+BlockMasks ClassifyBlock(const char* data)
+{
+	const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+	const __m128i quotes = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\'')));
+	const __m128i angles = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('<')), _mm_cmpeq_epi8(block, _mm_set1_epi8('>')));
+	const __m128i amps = _mm_cmpeq_epi8(block, _mm_set1_epi8('&'));
+	return { static_cast<uint32_t>(_mm_movemask_epi8(quotes)), static_cast<uint32_t>(_mm_movemask_epi8(angles)),
+		static_cast<uint32_t>(_mm_movemask_epi8(amps)) };
+}
+#endif
+} // namespace
+
+size_t GetHtmlEncodedSize(std::string_view text)
+{
+	size_t size = text.size();
+	size_t i = 0;
+#ifdef HTML_ENCODE_SSE2
+	for (; i + BLOCK_SIZE <= text.size(); i += BLOCK_SIZE)
+	{
+		const BlockMasks masks = ClassifyBlock(text.data() + i);
+		size += 5 * std::popcount(masks.quotes) + 3 * std::popcount(masks.angles) + 4 * std::popcount(masks.amps);
+	}
+#endif
+	for (; i < text.size(); i++)
+	{
+		size += ENCODE_TABLE.extra[static_cast<unsigned char>(text[i])];
+	}
+	return size;
+}
+
+std::string HtmlEncode(std::string const& text)
+{
+	std::string result(GetHtmlEncodedSize(text), '\0');
+	if (result.size() == text.size())
+	{
+		std::memcpy(result.data(), text.data(), text.size());
+		return result;
+	}
+
+	char* out = result.data();
+	auto writeEntity = [&out](char ch) {
+		const std::string_view entity = ENCODE_TABLE.entity[static_cast<unsigned char>(ch)];
+		std::memcpy(out, entity.data(), entity.size());
+		out += entity.size();
+	};
+
+	// Текст между заменяемыми символами копируется целиком
+	size_t copied = 0;
+	size_t i = 0;
+#ifdef HTML_ENCODE_SSE2
+	for (; i + BLOCK_SIZE <= text.size(); i += BLOCK_SIZE)
+	{
+		const BlockMasks masks = ClassifyBlock(text.data() + i);
+		for (uint32_t special = masks.quotes | masks.angles | masks.amps; special != 0; special &= special - 1)
+		{
+			const size_t pos = i + std::countr_zero(special);
+			std::memcpy(out, text.data() + copied, pos - copied);
+			out += pos - copied;
+			writeEntity(text[pos]);
+			copied = pos + 1;
+		}
+	}
+#endif
+	for (; i < text.size(); i++)
+	{
+		if (ENCODE_TABLE.extra[static_cast<unsigned char>(text[i])] != 0)
+		{
+			std::memcpy(out, text.data() + copied, i - copied);
+			out += i - copied;
+			writeEntity(text[i]);
+			copied = i + 1;
+		}
+	}
+	std::memcpy(out, text.data() + copied, text.size() - copied);
+	return result;
+}
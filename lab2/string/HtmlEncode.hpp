@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Заменяет " ' < > & на &quot; &apos; &lt; &gt; &amp;. HtmlDecode восстанавливает исходный текст
+std::string HtmlEncode(std::string const& text);
+
+// Точная длина HtmlEncode(text)
+size_t GetHtmlEncodedSize(std::string_view text);
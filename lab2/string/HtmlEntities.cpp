@@ -0,0 +1,85 @@
+#include "HtmlEntities.hpp"
+#include <cstdint>
+
+namespace
+{
+#include "HtmlEntityTable.inc"
+
+// FNV-1a с затравкой, должна совпадать с hash_name в generate_html_entities.py
+uint32_t HashEntityName(std::string_view name, uint32_t seed)
+{
+	uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+	for (char ch : name)
+	{
+		hash ^= static_cast<unsigned char>(ch);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Коды 0x80-0x9F, которые браузеры читают как символы windows-1252
+const uint16_t WINDOWS_1252_CONTROLS[32] = {
+	0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+	0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+};
+
+const uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+} // namespace
+
+std::span<const HtmlEntity> GetHtmlEntities()
+{
+	return HTML_ENTITIES;
+}
+
+std::string_view FindHtmlEntity(std::string_view name)
+{
+	if (name.empty() || name.size() > MAX_ENTITY_NAME_LENGTH)
+	{
+		return {};
+	}
+	const uint32_t seed = ENTITY_DISPLACEMENTS[HashEntityName(name, 0) % ENTITY_BUCKET_COUNT];
+	const uint16_t index = ENTITY_SLOTS[HashEntityName(name, seed) % ENTITY_SLOT_COUNT];
+	if (index == EMPTY_ENTITY_SLOT || HTML_ENTITIES[index].name != name)
+	{
+		return {};
+	}
+	return HTML_ENTITIES[index].text;
+}
+
+size_t EncodeCharacterReference(uint32_t codePoint, char* out)
+{
+	if (codePoint == 0 || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+	{
+		codePoint = REPLACEMENT_CHARACTER;
+	}
+	else if (codePoint >= 0x80 && codePoint <= 0x9F)
+	{
+		codePoint = WINDOWS_1252_CONTROLS[codePoint - 0x80];
+	}
+
+	if (codePoint < 0x80)
+	{
+		out[0] = static_cast<char>(codePoint);
+		return 1;
+	}
+	if (codePoint < 0x800)
+	{
+		out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+		out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+		return 2;
+	}
+	if (codePoint < 0x10000)
+	{
+		out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+		out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+		return 3;
+	}
+	out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+	out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+	out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+	out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+	return 4;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+struct HtmlEntity
+{
+	std::string_view name;
+	std::string_view text;
+};
+
+// Самое длинное имя именованной сущности HTML5 - CounterClockwiseContourIntegral
+const size_t MAX_ENTITY_NAME_LENGTH = 31;
+
+std::span<const HtmlEntity> GetHtmlEntities();
+
+// UTF-8 текст именованной сущности по имени без '&' и ';' или пустая строка, если такой нет.
+// Поиск по идеальному хешу без выделения памяти: одно вычисление хеша и одно сравнение строк
+std::string_view FindHtmlEntity(std::string_view name);
+
+// Символ с кодом codePoint в UTF-8 по правилам числовых ссылок HTML5:
+// 0, суррогаты и коды за U+10FFFF заменяются на U+FFFD, 0x80-0x9F - по таблице windows-1252.
+// Возвращает число записанных в out байт (не больше 4)
+size_t EncodeCharacterReference(uint32_t codePoint, char* out);
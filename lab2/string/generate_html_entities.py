@@ -0,0 +1,76 @@
+# Генерирует HtmlEntityTable.inc - идеальный хеш по именам именованных сущностей HTML5.
+# Запуск: python3 generate_html_entities.py > HtmlEntityTable.inc
+# Хеш-функция должна совпадать с HashEntityName в HtmlEntities.cpp
+import html.entities
+import string
+
+SLOT_COUNT = 4096
+BUCKET_COUNT = 1024
+EMPTY_SLOT = 0xFFFF
+
+
+def hash_name(name, seed):
+    h = (2166136261 ^ (seed * 0x9E3779B9)) & 0xFFFFFFFF
+    for byte in name.encode():
+        h ^= byte
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def escape(text):
+    result = ''
+    escaped = False
+    for byte in text.encode():
+        if 32 <= byte < 127 and chr(byte) not in '"\\?':
+            # Шестнадцатеричная цифра сразу после \xNN продолжила бы escape-последовательность
+            if escaped and chr(byte) in string.hexdigits:
+                result += '" "'
+            result += chr(byte)
+            escaped = False
+        else:
+            result += '\\x%02X' % byte
+            escaped = True
+    return result
+
+
+# Без ';' сущности не декодируются, поэтому устаревшие имена без неё не нужны
+names = sorted(name[:-1] for name in html.entities.html5 if name.endswith(';'))
+
+buckets = [[] for _ in range(BUCKET_COUNT)]
+for index, name in enumerate(names):
+    buckets[hash_name(name, 0) % BUCKET_COUNT].append(index)
+
+slots = [EMPTY_SLOT] * SLOT_COUNT
+displacements = [0] * BUCKET_COUNT
+for bucket in sorted(range(BUCKET_COUNT), key=lambda b: -len(buckets[b])):
+    if not buckets[bucket]:
+        continue
+    seed = 1
+    while True:
+        positions = [hash_name(names[index], seed) % SLOT_COUNT for index in buckets[bucket]]
+        if len(set(positions)) == len(positions) and all(slots[p] == EMPTY_SLOT for p in positions):
+            break
+        seed += 1
+    displacements[bucket] = seed
+    for index, position in zip(buckets[bucket], positions):
+        slots[position] = index
+
+print('// Сгенерировано generate_html_entities.py, не редактировать вручную')
+print('const size_t ENTITY_SLOT_COUNT = %d;' % SLOT_COUNT)
+print('const size_t ENTITY_BUCKET_COUNT = %d;' % BUCKET_COUNT)
+print('const uint16_t EMPTY_ENTITY_SLOT = 0x%X;' % EMPTY_SLOT)
+print()
+print('const HtmlEntity HTML_ENTITIES[] = {')
+for name in names:
+    print('\t{ "%s", "%s" },' % (name, escape(html.entities.html5[name + ';'])))
+print('};')
+print()
+print('const uint16_t ENTITY_DISPLACEMENTS[ENTITY_BUCKET_COUNT] = {')
+for i in range(0, BUCKET_COUNT, 16):
+    print('\t' + ', '.join(str(d) for d in displacements[i:i + 16]) + ',')
+print('};')
+print()
+print('const uint16_t ENTITY_SLOTS[ENTITY_SLOT_COUNT] = {')
+for i in range(0, SLOT_COUNT, 16):
+    print('\t' + ', '.join(str(s) for s in slots[i:i + 16]) + ',')
+print('};')
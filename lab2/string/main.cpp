@@ -1,13 +1,97 @@
+#include "BufferedIO.hpp"
 #include "HtmlDecode.hpp"
+#include "HtmlDecodeParallel.hpp"
+#include "MappedFile.hpp"
 #include <iostream>
+#include <optional>
+#include <string>
+
+struct Args
+{
+	std::optional<std::string> inputFileName;
+	unsigned threadCount = 0;
+};
+
+std::optional<Args> ParseArgs(int argc, char* argv[])
+{
+	Args args;
+	int i = 1;
+	if (i + 1 < argc && std::string(argv[i]) == "--threads")
+	{
+		try
+		{
+			args.threadCount = static_cast<unsigned>(std::stoul(argv[i + 1]));
+		}
+		catch (const std::exception&)
+		{
+			return std::nullopt;
+		}
+		i += 2;
+	}
+	if (i + 1 == argc)
+	{
+		args.inputFileName = argv[i];
+	}
+	else if (i != argc || args.threadCount != 0)
+	{
+		return std::nullopt;
+	}
+	return args;
+}
+
+// Вход читается большими блоками, ссылки на границах блоков склеивает HtmlDecoder
+char DecodeStream(std::istream& input, BufferedWriter& output)
+{
+	HtmlDecoder decoder([&output](std::string_view text) { output.Write(text); });
+	BufferedReader reader(input);
+	char lastChar = '\n';
+	for (auto block = reader.ReadBlock(); !block.empty(); block = reader.ReadBlock())
+	{
+		decoder.Feed(block);
+		lastChar = block.back();
+	}
+	decoder.Finish();
+	return lastChar;
+}
+
+// Файл отображается в память целиком и декодируется по строкам на нескольких потоках
+char DecodeFile(const std::string& fileName, unsigned threadCount, BufferedWriter& output)
+{
+	MappedFile file(fileName);
+	std::string_view html(file.Data(), file.Size());
+	HtmlDecodeParallel(html, [&output](std::string_view text) { output.Write(text); }, threadCount != 0 ? threadCount : GetDefaultThreadCount());
+	return html.empty() ? '\n' : html.back();
+}
 
 int main(int argc, char* argv[])
 {
-	std::string line;
-	while (std::getline(std::cin, line))
+	std::ios::sync_with_stdio(false);
+
+	auto args = ParseArgs(argc, argv);
+	if (!args)
+	{
+		std::cerr << "Usage: html-decode [[--threads <count>] <input file>]\n";
+		return 1;
+	}
+
+	BufferedWriter output(std::cout);
+	char lastChar = '\n';
+	try
+	{
+		lastChar = args->inputFileName ? DecodeFile(*args->inputFileName, args->threadCount, output) : DecodeStream(std::cin, output);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+
+	// Как и при построчном выводе, последняя строка всегда завершается переводом строки
+	if (lastChar != '\n')
 	{
-		std::cout << HtmlDecode(line) << std::endl;
+		output.Put('\n');
 	}
+	output.Flush();
 
 	return 0;
 }
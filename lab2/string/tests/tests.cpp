@@ -2,9 +2,14 @@
 #include <catch2/matchers/catch_matchers_string.hpp>
 
 #include "HtmlDecode.hpp"
+#include "HtmlDecodeParallel.hpp"
+#include "HtmlEncode.hpp"
 
+#include <algorithm>
+#include <random>
 #include <sstream>
 #include <string>
+#include <vector>
 
 TEST_CASE("HtmlDecode decodes HTML entities back to characters", "[HtmlDecode]")
 {
@@ -103,9 +108,16 @@ TEST_CASE("HtmlDecode decodes HTML entities back to characters", "[HtmlDecode]")
         REQUIRE(HtmlDecode(textWithAmp) == "a&a"); // & без ; не декодируется
     }
 
+    SECTION("Copies long text between entities unchanged")
+    {
+        std::string text(5000, 'x');
+        REQUIRE(HtmlDecode(text + "&lt;" + text + "&" + text + "&gt;") == text + "<" + text + "&" + text + ">");
+        REQUIRE(HtmlDecode("&am&amp;p;") == "&am&p;");
+    }
+
     SECTION("Handles entity-like strings that exceed max length")
     {
-        // &abcdef; - длина 7 (больше maxEntityLength=6)
+        // &abcdef; - неизвестные сущности остаются как есть
         REQUIRE(HtmlDecode("&abcdef;") == "&abcdef;");
         REQUIRE(HtmlDecode("&abcdefgh;") == "&abcdefgh;");
         REQUIRE(HtmlDecode("&quot; and &abcdef;") == "\" and &abcdef;");
@@ -200,4 +212,257 @@ TEST_CASE("HtmlDecode handles edge cases", "[HtmlDecode][edge]")
         REQUIRE(HtmlDecode("&amp;quot;") == "&quot;"); // &amp;quot; -> &quot;
         REQUIRE(HtmlDecode("&amp;amp;") == "&amp;");  // &amp;amp; -> &amp;
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("HtmlDecode decodes all HTML5 named entities", "[HtmlDecode][html5]")
+{
+    SECTION("Decodes named entities into UTF-8")
+    {
+        REQUIRE(HtmlDecode("&copy; 2024") == "\xC2\xA9 2024");
+        REQUIRE(HtmlDecode("a&nbsp;b") == "a\xC2\xA0" "b");
+        REQUIRE(HtmlDecode("&euro;&hearts;") == "\xE2\x82\xAC\xE2\x99\xA5");
+        REQUIRE(HtmlDecode("&AMP;&LT;&GT;&QUOT;") == "&<>\"");
+        REQUIRE(HtmlDecode("&CounterClockwiseContourIntegral;") == "\xE2\x88\xB3");
+    }
+
+    SECTION("Decodes entities made of two code points")
+    {
+        REQUIRE(HtmlDecode("&NotEqualTilde;") == "\xE2\x89\x82\xCC\xB8");
+        REQUIRE(HtmlDecode("&nGt;") == "\xE2\x89\xAB\xE2\x83\x92");
+        REQUIRE(HtmlDecode("&fjlig;") == "fj");
+    }
+
+    SECTION("Names are case sensitive and need a semicolon")
+    {
+        REQUIRE(HtmlDecode("&Copy;") == "&Copy;");
+        REQUIRE(HtmlDecode("&copy") == "&copy");
+        REQUIRE(HtmlDecode("&notin;&not") == "\xE2\x88\x89&not");
+        REQUIRE(HtmlDecode("&unknownentity;") == "&unknownentity;");
+    }
+}
+
+TEST_CASE("HtmlDecode decodes numeric character references", "[HtmlDecode][numeric]")
+{
+    SECTION("Decimal and hexadecimal references")
+    {
+        REQUIRE(HtmlDecode("&#60;&#62;") == "<>");
+        REQUIRE(HtmlDecode("&#x3C;&#X3e;") == "<>");
+        REQUIRE(HtmlDecode("&#169;") == "\xC2\xA9");
+        REQUIRE(HtmlDecode("&#x1F600;") == "\xF0\x9F\x98\x80");
+        REQUIRE(HtmlDecode("&#0000065;") == "A");
+    }
+
+    SECTION("Invalid code points become U+FFFD")
+    {
+        REQUIRE(HtmlDecode("&#0;") == "\xEF\xBF\xBD");
+        REQUIRE(HtmlDecode("&#xD800;") == "\xEF\xBF\xBD");
+        REQUIRE(HtmlDecode("&#x110000;") == "\xEF\xBF\xBD");
+        REQUIRE(HtmlDecode("&#99999999999999999999;") == "\xEF\xBF\xBD");
+    }
+
+    SECTION("C1 controls are read as windows-1252")
+    {
+        REQUIRE(HtmlDecode("&#128;") == "\xE2\x82\xAC");
+        REQUIRE(HtmlDecode("&#x99;") == "\xE2\x84\xA2");
+    }
+
+    SECTION("Malformed references stay unchanged")
+    {
+        REQUIRE(HtmlDecode("&#;") == "&#;");
+        REQUIRE(HtmlDecode("&#x;") == "&#x;");
+        REQUIRE(HtmlDecode("&#12a;") == "&#12a;");
+        REQUIRE(HtmlDecode("&#xZZ;") == "&#xZZ;");
+        REQUIRE(HtmlDecode("&#65") == "&#65");
+    }
+}
+
+TEST_CASE("HtmlDecoder decodes text split into arbitrary chunks", "[HtmlDecoder]")
+{
+    auto decodeInChunks = [](const std::string& html, size_t chunkSize) {
+        std::string result;
+        HtmlDecoder decoder([&result](std::string_view text) { result += text; });
+        for (size_t pos = 0; pos < html.size(); pos += chunkSize)
+        {
+            decoder.Feed(std::span<const char>(html.data() + pos, std::min(chunkSize, html.size() - pos)));
+        }
+        decoder.Finish();
+        return result;
+    };
+
+    SECTION("Entities split at every position are decoded")
+    {
+        const std::string html = "a &lt;b&gt; &amp;amp; &#x1F600; &CounterClockwiseContourIntegral; &quot &nGt; & &#65";
+        for (size_t chunkSize = 1; chunkSize <= html.size(); ++chunkSize)
+        {
+            REQUIRE(decodeInChunks(html, chunkSize) == HtmlDecode(html));
+        }
+    }
+
+    SECTION("Incomplete entity at the end is written as is")
+    {
+        REQUIRE(decodeInChunks("Tom &amp", 3) == "Tom &amp");
+        REQUIRE(decodeInChunks("&", 1) == "&");
+    }
+
+    SECTION("Long text without entities passes through")
+    {
+        std::string text(100000, 'x');
+        text += "&amp;";
+        REQUIRE(decodeInChunks(text, 4096) == std::string(100000, 'x') + "&");
+    }
+
+    SECTION("Empty chunks and empty input are allowed")
+    {
+        std::string result;
+        HtmlDecoder decoder([&result](std::string_view text) { result += text; });
+        decoder.Feed(std::span<const char>());
+        decoder.Feed(std::span<const char>("&l", 2));
+        decoder.Feed(std::span<const char>());
+        decoder.Feed(std::span<const char>("t;", 2));
+        decoder.Finish();
+        REQUIRE(result == "<");
+    }
+}
+
+TEST_CASE("HtmlDecodeInPlace and HtmlDecodeInto match HtmlDecode", "[HtmlDecode][inplace]")
+{
+    const std::vector<std::string> samples = {
+        "",
+        "plain text",
+        "Cat &lt;says&gt; &quot;Meow&quot;. M&amp;M&apos;s",
+        "&amp;amp; &#x1F600; &#0; &copy &unknown; & &",
+        "&nGt;",
+        "&nGt;&nLt;&nGt;&nLt;&nGt;",
+        "x&nGt;&lt;&nLt;&amp;&nGt;&nGt;&nGt;&nGt;&nGt;&nGt; tail",
+        "&lt;&lt;&lt;&nGt;&nGt;&nGt;&nGt;&nGt;&nGt;&nGt;",
+    };
+
+    SECTION("HtmlDecodeInPlace returns the decoded length and shrinks the string")
+    {
+        for (const std::string& sample : samples)
+        {
+            std::string html = sample;
+            size_t length = HtmlDecodeInPlace(html);
+            REQUIRE(html == HtmlDecode(sample));
+            REQUIRE(length == html.size());
+        }
+    }
+
+    SECTION("HtmlDecodeInPlace does not reallocate when the text does not grow")
+    {
+        std::string html = "&lt;div&gt;" + std::string(1000, 'x') + "&lt;/div&gt;";
+        const char* data = html.data();
+        HtmlDecodeInPlace(html);
+        REQUIRE(html == "<div>" + std::string(1000, 'x') + "</div>");
+        REQUIRE(html.data() == data);
+    }
+
+    SECTION("HtmlDecodeInto writes into a caller buffer")
+    {
+        for (const std::string& sample : samples)
+        {
+            std::vector<char> out(GetMaxDecodedSize(sample.size()));
+            size_t length = HtmlDecodeInto(sample, out.data());
+            REQUIRE(std::string(out.data(), length) == HtmlDecode(sample));
+        }
+    }
+}
+
+TEST_CASE("HtmlEncode escapes special characters", "[HtmlEncode]")
+{
+    SECTION("Replaces each special character with its entity")
+    {
+        REQUIRE(HtmlEncode("") == "");
+        REQUIRE(HtmlEncode("Hello World") == "Hello World");
+        REQUIRE(HtmlEncode("Cat <says> \"Meow\". M&M's") == "Cat &lt;says&gt; &quot;Meow&quot;. M&amp;M&apos;s");
+        REQUIRE(HtmlEncode("&amp;") == "&amp;amp;");
+        REQUIRE(HtmlEncode("<<<<<<<<<<<<<<<<<<<<") == "&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;");
+    }
+
+    SECTION("Leaves UTF-8 and control characters unchanged")
+    {
+        const char raw[] = "\xC2\xA9 \xF0\x9F\x98\x80\t\n\0 end";
+        const std::string text(raw, sizeof(raw) - 1);
+        REQUIRE(HtmlEncode(text) == text);
+    }
+
+    SECTION("Predicted size matches the result around block boundaries")
+    {
+        for (size_t length = 0; length <= 40; ++length)
+        {
+            std::string text(length, 'a');
+            for (size_t i = 0; i < length; i += 3)
+            {
+                text[i] = "\"'<>&"[i % 5];
+            }
+            REQUIRE(GetHtmlEncodedSize(text) == HtmlEncode(text).size());
+            REQUIRE(HtmlEncode(text).find_first_of("\"'<>") == std::string::npos);
+        }
+    }
+}
+
+TEST_CASE("HtmlDecode restores HtmlEncode output", "[HtmlEncode][roundtrip]")
+{
+    SECTION("Random texts survive encode and decode")
+    {
+        const std::string alphabet = "ab \"'<>&;#x1\n\xC3\xA9";
+        std::mt19937 random(2024);
+        std::uniform_int_distribution<size_t> symbol(0, alphabet.size() - 1);
+        std::uniform_int_distribution<size_t> length(0, 100);
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::string text;
+            for (size_t n = length(random); n > 0; --n)
+            {
+                text += alphabet[symbol(random)];
+            }
+            REQUIRE(HtmlDecode(HtmlEncode(text)) == text);
+        }
+    }
+
+    SECTION("Text that already looks like entities is preserved")
+    {
+        const std::string text = "&lt; &amp;amp; &#60; &copy; &nGt; &";
+        REQUIRE(HtmlDecode(HtmlEncode(text)) == text);
+    }
+}
+
+TEST_CASE("HtmlDecodeParallel matches serial decoding", "[HtmlDecode][parallel]")
+{
+    auto decodeParallel = [](const std::string& html, unsigned threadCount, size_t blockSize) {
+        std::string result;
+        HtmlDecodeParallel(html, [&result](std::string_view text) { result += text; }, threadCount, blockSize);
+        return result;
+    };
+
+    SECTION("Random multi-line texts are decoded identically for any block size")
+    {
+        const std::vector<std::string> pieces = { "text ", "&lt;", "&amp;amp;", "&#x1F600;", "&nGt;", "&quot", "&", "\n", "\n\n" };
+        std::mt19937 random(40);
+        std::uniform_int_distribution<size_t> piece(0, pieces.size() - 1);
+        std::string html;
+        for (int i = 0; i < 5000; ++i)
+        {
+            html += pieces[piece(random)];
+        }
+        const std::string expected = HtmlDecode(html);
+        for (size_t blockSize : { 1, 7, 100, 4096, 1 << 20 })
+        {
+            for (unsigned threadCount : { 1, 2, 4 })
+            {
+                REQUIRE(decodeParallel(html, threadCount, blockSize) == expected);
+            }
+        }
+    }
+
+    SECTION("Text without line breaks is decoded as one block")
+    {
+        const std::string html = std::string(1000, 'x') + "&amp;";
+        REQUIRE(decodeParallel(html, 4, 10) == std::string(1000, 'x') + "&");
+    }
+
+    SECTION("Empty text produces no output")
+    {
+        REQUIRE(decodeParallel("", 4, 10).empty());
+    }
+}
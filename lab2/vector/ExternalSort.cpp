@@ -0,0 +1,213 @@
+#include "ExternalSort.hpp"
+#include "Numbers.hpp"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+const size_t MIN_MERGE_BUFFER_SIZE = 1 << 12;
+
+// Временные файлы серий, удаляются вместе с объектом
+class RunFiles
+{
+public:
+	explicit RunFiles(const std::filesystem::path& tempDir)
+		: m_prefix((tempDir / ("vec-" + std::to_string(std::random_device()()) + "-")).string())
+	{
+	}
+
+	~RunFiles()
+	{
+		for (const auto& path : m_paths)
+		{
+			std::error_code error;
+			std::filesystem::remove(path, error);
+		}
+	}
+
+	RunFiles(const RunFiles&) = delete;
+	RunFiles& operator=(const RunFiles&) = delete;
+
+	void Write(std::span<const double> run)
+	{
+		m_paths.emplace_back(m_prefix + std::to_string(m_paths.size()) + ".run");
+		std::ofstream file(m_paths.back(), std::ios::binary);
+		if (!file.write(reinterpret_cast<const char*>(run.data()), run.size() * sizeof(double)) || !file.flush())
+		{
+			throw std::runtime_error("Can't write temporary file " + m_paths.back().string());
+		}
+	}
+
+	const std::vector<std::filesystem::path>& Paths() const { return m_paths; }
+
+private:
+	std::string m_prefix;
+	std::vector<std::filesystem::path> m_paths;
+};
+
+// Последовательное чтение отсортированной серии через буфер
+class RunReader
+{
+public:
+	RunReader(const std::filesystem::path& path, size_t bufferSize)
+		: m_file(path, std::ios::binary)
+		, m_buffer(bufferSize)
+	{
+		if (!m_file)
+		{
+			throw std::runtime_error("Can't open temporary file " + path.string());
+		}
+		Fill();
+	}
+
+	bool Empty() const { return m_pos == m_size; }
+	double Current() const { return m_buffer[m_pos]; }
+
+	void Next()
+	{
+		if (++m_pos == m_size)
+		{
+			Fill();
+		}
+	}
+
+private:
+	void Fill()
+	{
+		m_file.read(reinterpret_cast<char*>(m_buffer.data()), m_buffer.size() * sizeof(double));
+		m_size = static_cast<size_t>(m_file.gcount()) / sizeof(double);
+		m_pos = 0;
+	}
+
+	std::ifstream m_file;
+	std::vector<double> m_buffer;
+	size_t m_pos = 0;
+	size_t m_size = 0;
+};
+
+// Дерево проигравших: во внутренних узлах лежат серии, проигравшие матч, в m_tree[0] - победитель.
+// После выдачи минимума переигрываются только матчи на пути от листа победителя к корню
+class LoserTree
+{
+public:
+	explicit LoserTree(std::vector<RunReader>& runs)
+		: m_runs(runs)
+		, m_tree(runs.size())
+	{
+		const size_t k = runs.size();
+		std::vector<size_t> winners(2 * k);
+		for (size_t i = 0; i < k; i++)
+		{
+			winners[k + i] = i;
+		}
+		for (size_t node = k - 1; node >= 1; node--)
+		{
+			const size_t a = winners[2 * node];
+			const size_t b = winners[2 * node + 1];
+			winners[node] = Less(a, b) ? a : b;
+			m_tree[node] = Less(a, b) ? b : a;
+		}
+		m_tree[0] = winners[1];
+	}
+
+	bool Empty() const { return m_runs[m_tree[0]].Empty(); }
+	double Top() const { return m_runs[m_tree[0]].Current(); }
+
+	void Pop()
+	{
+		size_t winner = m_tree[0];
+		m_runs[winner].Next();
+		for (size_t node = (winner + m_runs.size()) / 2; node >= 1; node /= 2)
+		{
+			if (Less(m_tree[node], winner))
+			{
+				std::swap(m_tree[node], winner);
+			}
+		}
+		m_tree[0] = winner;
+	}
+
+private:
+	// Закончившаяся серия проигрывает всем
+	bool Less(size_t a, size_t b) const
+	{
+		if (m_runs[a].Empty() || m_runs[b].Empty())
+		{
+			return !m_runs[a].Empty();
+		}
+		return IsNumberLess(m_runs[a].Current(), m_runs[b].Current());
+	}
+
+	std::vector<RunReader>& m_runs;
+	std::vector<size_t> m_tree;
+};
+} // namespace
+
+void ProcessNumbersExternal(std::istream& in, std::ostream& out, size_t memoryLimit, const std::filesystem::path& tempDir)
+{
+	// Серия и буфер поразрядной сортировки занимают по 8 байт на число.
+	// Серии режутся по границам блоков суммы, чтобы среднее совпало с обработкой в памяти
+	const size_t runSize = std::max(memoryLimit / (2 * sizeof(double)) / PARALLEL_SUM_BLOCK_SIZE, size_t(1)) * PARALLEL_SUM_BLOCK_SIZE;
+
+	NumberStreamReader reader(in);
+	RunFiles runFiles(tempDir);
+	PositiveSumAccumulator positive;
+	std::vector<double> nums;
+	nums.reserve(runSize + NUMBER_STREAM_BLOCK_SIZE / 2);
+
+	auto spillRun = [&](size_t size) {
+		std::span<double> run(nums.data(), size);
+		positive.Add(run);
+		SortNumbers(run);
+		runFiles.Write(run);
+		nums.erase(nums.begin(), nums.begin() + size);
+	};
+	while (reader.ReadBlock(nums))
+	{
+		while (nums.size() >= runSize)
+		{
+			spillRun(runSize);
+		}
+	}
+	if (!runFiles.Paths().empty() && !nums.empty())
+	{
+		spillRun(nums.size());
+	}
+
+	SortedNumberWriter writer(out);
+	// Всё поместилось в одну серию: обходимся без временных файлов
+	if (runFiles.Paths().empty())
+	{
+		positive.Add(nums);
+		SortNumbers(nums);
+		const NumberShift shift(positive.Result());
+		for (double n : nums)
+		{
+			writer.Write(shift(n));
+		}
+		writer.Finish();
+		return;
+	}
+
+	std::vector<double>().swap(nums);
+	const size_t bufferSize = std::max(memoryLimit / sizeof(double) / runFiles.Paths().size(), MIN_MERGE_BUFFER_SIZE);
+	std::vector<RunReader> runs;
+	runs.reserve(runFiles.Paths().size());
+	for (const auto& path : runFiles.Paths())
+	{
+		runs.emplace_back(path, bufferSize);
+	}
+
+	const NumberShift shift(positive.Result());
+	for (LoserTree tree(runs); !tree.Empty(); tree.Pop())
+	{
+		writer.Write(shift(tree.Top()));
+	}
+	writer.Finish();
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+
+// То же, что PrintSortedNumbers(ProcessNumbers(ReadNumbers(in)), out), но для наборов больше памяти:
+// используется около memoryLimit байт. Числа читаются потоком и режутся на серии, каждая сортируется
+// и сбрасывается во временный файл в tempDir как массив double. Суммы блоков для среднего
+// положительных копятся на том же проходе. Затем серии сливаются деревом проигравших с прибавлением среднего.
+// Временные файлы удаляются и при ошибке
+void ProcessNumbersExternal(std::istream& in, std::ostream& out, size_t memoryLimit, const std::filesystem::path& tempDir);
@@ -0,0 +1,329 @@
+#include "NumberFile.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+const char NUMBER_FILE_MAGIC[4] = { '\x89', 'N', 'U', 'M' };
+const uint32_t NUMBER_FILE_VERSION = 1;
+const unsigned LEADING_ZEROS_BITS = 5;
+const unsigned MEANINGFUL_BITS = 6;
+
+template <typename T>
+void StoreLittleEndian(std::vector<char>& out, T value)
+{
+	for (size_t i = 0; i < sizeof(T); i++)
+	{
+		out.push_back(static_cast<char>(static_cast<uint64_t>(value) >> (8 * i)));
+	}
+}
+
+template <typename T>
+T LoadLittleEndian(const char* data)
+{
+	uint64_t value = 0;
+	for (size_t i = 0; i < sizeof(T); i++)
+	{
+		value |= uint64_t(static_cast<unsigned char>(data[i])) << (8 * i);
+	}
+	return static_cast<T>(value);
+}
+
+[[noreturn]] void ThrowCorrupted(const std::string& fileName)
+{
+	throw std::runtime_error("Corrupted number file " + fileName);
+}
+
+// Биты пишутся от старших к младшим
+class BitWriter
+{
+public:
+	explicit BitWriter(std::vector<char>& out)
+		: m_out(out)
+	{
+	}
+
+	void Write(uint64_t value, unsigned count)
+	{
+		while (count > 0)
+		{
+			const unsigned take = std::min(count, 8 - m_bits);
+			count -= take;
+			m_byte = static_cast<uint8_t>((m_byte << take) | ((value >> count) & ((1u << take) - 1)));
+			m_bits += take;
+			if (m_bits == 8)
+			{
+				m_out.push_back(static_cast<char>(m_byte));
+				m_byte = 0;
+				m_bits = 0;
+			}
+		}
+	}
+
+	void Finish()
+	{
+		if (m_bits != 0)
+		{
+			m_out.push_back(static_cast<char>(m_byte << (8 - m_bits)));
+			m_byte = 0;
+			m_bits = 0;
+		}
+	}
+
+private:
+	std::vector<char>& m_out;
+	uint8_t m_byte = 0;
+	unsigned m_bits = 0;
+};
+
+class BitReader
+{
+public:
+	BitReader(const char* data, size_t size)
+		: m_data(reinterpret_cast<const uint8_t*>(data))
+		, m_size(size)
+	{
+	}
+
+	// false, если битов не хватило
+	bool Read(unsigned count, uint64_t& value)
+	{
+		if (count > m_size * 8 - m_pos)
+		{
+			return false;
+		}
+		value = 0;
+		while (count > 0)
+		{
+			const unsigned offset = static_cast<unsigned>(m_pos % 8);
+			const unsigned take = std::min(count, 8 - offset);
+			const unsigned bits = (m_data[m_pos / 8] >> (8 - offset - take)) & ((1u << take) - 1);
+			value = (value << take) | bits;
+			count -= take;
+			m_pos += take;
+		}
+		return true;
+	}
+
+private:
+	const uint8_t* m_data;
+	size_t m_size;
+	size_t m_pos = 0;
+};
+
+// Окно значащих битов XOR: число ведущих и завершающих нулей
+struct XorWindow
+{
+	unsigned leading = 64;
+	unsigned trailing = 0;
+};
+
+void EncodeXorBlock(std::span<const double> block, std::vector<char>& out)
+{
+	std::vector<char> bits;
+	BitWriter writer(bits);
+	uint64_t previous = std::bit_cast<uint64_t>(block[0]);
+	writer.Write(previous, 64);
+	XorWindow window;
+	for (double n : block.subspan(1))
+	{
+		const uint64_t current = std::bit_cast<uint64_t>(n);
+		const uint64_t delta = current ^ previous;
+		previous = current;
+		if (delta == 0)
+		{
+			writer.Write(0, 1);
+			continue;
+		}
+		writer.Write(1, 1);
+		const unsigned leading = std::min(static_cast<unsigned>(std::countl_zero(delta)), (1u << LEADING_ZEROS_BITS) - 1);
+		const unsigned trailing = static_cast<unsigned>(std::countr_zero(delta));
+		// Значащие биты помещаются в окно предыдущего значения: пишем только их
+		if (window.leading != 64 && leading >= window.leading && trailing >= window.trailing)
+		{
+			writer.Write(0, 1);
+			writer.Write(delta >> window.trailing, 64 - window.leading - window.trailing);
+			continue;
+		}
+		window = { leading, trailing };
+		const unsigned meaningful = 64 - leading - trailing;
+		writer.Write(1, 1);
+		writer.Write(leading, LEADING_ZEROS_BITS);
+		writer.Write(meaningful - 1, MEANINGFUL_BITS);
+		writer.Write(delta >> trailing, meaningful);
+	}
+	writer.Finish();
+
+	StoreLittleEndian(out, static_cast<uint32_t>(block.size()));
+	StoreLittleEndian(out, static_cast<uint32_t>(bits.size()));
+	out.insert(out.end(), bits.begin(), bits.end());
+}
+
+bool DecodeXorBlock(const char* data, size_t size, size_t count, std::vector<double>& nums)
+{
+	BitReader reader(data, size);
+	uint64_t previous;
+	if (!reader.Read(64, previous))
+	{
+		return false;
+	}
+	nums.push_back(std::bit_cast<double>(previous));
+	XorWindow window;
+	for (size_t i = 1; i < count; i++)
+	{
+		uint64_t changed, newWindow;
+		if (!reader.Read(1, changed))
+		{
+			return false;
+		}
+		if (changed)
+		{
+			if (!reader.Read(1, newWindow))
+			{
+				return false;
+			}
+			if (newWindow)
+			{
+				uint64_t leading, meaningful;
+				if (!reader.Read(LEADING_ZEROS_BITS, leading) || !reader.Read(MEANINGFUL_BITS, meaningful)
+					|| leading + meaningful + 1 > 64)
+				{
+					return false;
+				}
+				window = { static_cast<unsigned>(leading), static_cast<unsigned>(64 - leading - meaningful - 1) };
+			}
+			else if (window.leading == 64)
+			{
+				return false;
+			}
+			uint64_t delta;
+			if (!reader.Read(64 - window.leading - window.trailing, delta))
+			{
+				return false;
+			}
+			previous ^= delta << window.trailing;
+		}
+		nums.push_back(std::bit_cast<double>(previous));
+	}
+	return true;
+}
+} // namespace
+
+bool IsNumberFile(const std::string& fileName)
+{
+	std::ifstream input(fileName, std::ios::binary);
+	char magic[sizeof(NUMBER_FILE_MAGIC)];
+	return input.read(magic, sizeof(magic)) && std::memcmp(magic, NUMBER_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+void WriteNumberFile(const std::string& fileName, std::span<const double> nums, NumberEncoding encoding)
+{
+	std::vector<char> header(NUMBER_FILE_MAGIC, NUMBER_FILE_MAGIC + sizeof(NUMBER_FILE_MAGIC));
+	StoreLittleEndian(header, NUMBER_FILE_VERSION);
+	StoreLittleEndian(header, static_cast<uint32_t>(encoding));
+	StoreLittleEndian(header, static_cast<uint32_t>(encoding == NumberEncoding::XOR ? XOR_BLOCK_SIZE : 0));
+	StoreLittleEndian(header, static_cast<uint64_t>(nums.size()));
+	StoreLittleEndian(header, uint64_t(0));
+
+	std::ofstream output(fileName, std::ios::binary);
+	if (!output)
+	{
+		throw std::runtime_error("Can't open file " + fileName);
+	}
+	output.write(header.data(), header.size());
+
+	std::vector<char> data;
+	for (size_t begin = 0; begin < nums.size(); begin += XOR_BLOCK_SIZE)
+	{
+		std::span<const double> block = nums.subspan(begin, std::min(XOR_BLOCK_SIZE, nums.size() - begin));
+		data.clear();
+		if (encoding == NumberEncoding::XOR)
+		{
+			EncodeXorBlock(block, data);
+		}
+		else if constexpr (std::endian::native == std::endian::little)
+		{
+			data.resize(block.size_bytes());
+			std::memcpy(data.data(), block.data(), block.size_bytes());
+		}
+		else
+		{
+			for (double n : block)
+			{
+				StoreLittleEndian(data, std::bit_cast<uint64_t>(n));
+			}
+		}
+		output.write(data.data(), data.size());
+	}
+	if (!output.flush())
+	{
+		throw std::runtime_error("Can't write file " + fileName);
+	}
+}
+
+NumberFile::NumberFile(const std::string& fileName)
+	: m_file(fileName)
+{
+	const char* data = m_file.Data();
+	const size_t size = m_file.Size();
+	if (size < NUMBER_FILE_HEADER_SIZE || std::memcmp(data, NUMBER_FILE_MAGIC, sizeof(NUMBER_FILE_MAGIC)) != 0
+		|| LoadLittleEndian<uint32_t>(data + 4) != NUMBER_FILE_VERSION)
+	{
+		ThrowCorrupted(fileName);
+	}
+	const auto encoding = static_cast<NumberEncoding>(LoadLittleEndian<uint32_t>(data + 8));
+	const uint64_t count = LoadLittleEndian<uint64_t>(data + 16);
+	const char* payload = data + NUMBER_FILE_HEADER_SIZE;
+	const size_t payloadSize = size - NUMBER_FILE_HEADER_SIZE;
+
+	if (encoding == NumberEncoding::RAW)
+	{
+		if (count != payloadSize / sizeof(double) || payloadSize % sizeof(double) != 0)
+		{
+			ThrowCorrupted(fileName);
+		}
+		if constexpr (std::endian::native == std::endian::little)
+		{
+			m_numbers = std::span<const double>(reinterpret_cast<const double*>(payload), count);
+			return;
+		}
+		m_decoded.reserve(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			m_decoded.push_back(std::bit_cast<double>(LoadLittleEndian<uint64_t>(payload + i * sizeof(double))));
+		}
+	}
+	else if (encoding == NumberEncoding::XOR)
+	{
+		m_decoded.reserve(count);
+		size_t pos = 0;
+		while (m_decoded.size() < count)
+		{
+			if (payloadSize - pos < 8)
+			{
+				ThrowCorrupted(fileName);
+			}
+			const uint32_t blockCount = LoadLittleEndian<uint32_t>(payload + pos);
+			const uint32_t blockSize = LoadLittleEndian<uint32_t>(payload + pos + 4);
+			pos += 8;
+			if (blockCount == 0 || blockCount > count - m_decoded.size() || blockSize > payloadSize - pos
+				|| !DecodeXorBlock(payload + pos, blockSize, blockCount, m_decoded))
+			{
+				ThrowCorrupted(fileName);
+			}
+			pos += blockSize;
+		}
+		if (pos != payloadSize)
+		{
+			ThrowCorrupted(fileName);
+		}
+	}
+	else
+	{
+		ThrowCorrupted(fileName);
+	}
+	m_numbers = m_decoded;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// Двоичный формат чисел: 32-байтный заголовок и далее либо сами double в little-endian,
+// либо блоки со сжатием XOR соседних значений, как в Gorilla:
+//   заголовок: "\x89NUM", версия, кодировка, размер блока (u32), количество чисел (u64), резерв (u64)
+//   блок XOR: количество чисел и длина в байтах (u32), затем битовый поток
+enum class NumberEncoding : uint32_t
+{
+	RAW = 0,
+	XOR = 1,
+};
+
+const size_t NUMBER_FILE_HEADER_SIZE = 32;
+const size_t XOR_BLOCK_SIZE = 1 << 12;
+
+// Начинается ли файл с заголовка двоичного формата
+bool IsNumberFile(const std::string& fileName);
+
+void WriteNumberFile(const std::string& fileName, std::span<const double> nums, NumberEncoding encoding);
+
+// Файл чисел, отображённый в память. Несжатые числа на little-endian платформе не копируются:
+// Numbers() указывает прямо в отображение. Сжатые распаковываются в собственный буфер
+class NumberFile
+{
+public:
+	explicit NumberFile(const std::string& fileName);
+
+	NumberFile(const NumberFile&) = delete;
+	NumberFile& operator=(const NumberFile&) = delete;
+
+	std::span<const double> Numbers() const { return m_numbers; }
+
+private:
+	MappedFile m_file;
+	std::vector<double> m_decoded;
+	std::span<const double> m_numbers;
+};
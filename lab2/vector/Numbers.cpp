@@ -1,53 +1,586 @@
 #include "Numbers.hpp"
-#include <iomanip>
-#include <numeric>
+#include "BufferedIO.hpp"
+#include "CharConv.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
-std::vector<double> ReadNumbers(std::istream& in)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NUMBERS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NUMBERS_SSE2
+#endif
+
+namespace
 {
-	std::vector<double> nums;
-	double n;
+// По началу текста оценивается, сколько в нём чисел, чтобы выделить память под вектор один раз
+const size_t CAPACITY_SAMPLE_SIZE = 1 << 16;
+
+size_t EstimateNumberCount(std::string_view text)
+{
+	std::string_view sample = text.substr(0, CAPACITY_SAMPLE_SIZE);
+	size_t count = 0;
+	bool inNumber = false;
+	for (char ch : sample)
+	{
+		count += !inNumber && !IsSpace(ch);
+		inNumber = !IsSpace(ch);
+	}
+	return sample.size() == text.size() ? count : count * (text.size() / sample.size() + 1);
+}
 
-	while (in >> n)
+void AppendNumbers(std::string_view text, std::vector<double>& nums)
+{
+	const char* pos = text.data();
+	const char* end = pos + text.size();
+	while (true)
 	{
+		pos = std::find_if_not(pos, end, IsSpace);
+		if (pos == end)
+		{
+			break;
+		}
+
+		double n;
+		ParseResult result = ParseDouble(pos, end, n);
+		if (result == ParseResult::BadValue)
+		{
+			throw std::runtime_error("Bad value");
+		}
+		if (result == ParseResult::EndOfInput)
+		{
+			break;
+		}
 		nums.push_back(n);
 	}
+}
+
+// Записывает в to числа из from, увеличенные на avg. from и to могут совпадать
+void AddToAll(std::span<const double> from, std::span<double> to, double avg)
+{
+	size_t i = 0;
+#if defined(NUMBERS_AVX2)
+	const __m256d shift = _mm256_set1_pd(avg);
+	for (; i + 4 <= from.size(); i += 4)
+	{
+		_mm256_storeu_pd(to.data() + i, _mm256_add_pd(_mm256_loadu_pd(from.data() + i), shift));
+	}
+#elif defined(NUMBERS_SSE2)
+	const __m128d shift = _mm_set1_pd(avg);
+	for (; i + 2 <= from.size(); i += 2)
+	{
+		_mm_storeu_pd(to.data() + i, _mm_add_pd(_mm_loadu_pd(from.data() + i), shift));
+	}
+#endif
+	for (; i < from.size(); i++)
+	{
+		to[i] = from[i] + avg;
+	}
+}
+
+// Потоки по очереди берут блоки с номерами от 0 до blockCount
+template <typename Action>
+void ForEachBlock(size_t blockCount, unsigned threadCount, Action action)
+{
+	std::atomic<size_t> nextBlock = 0;
+	auto worker = [&]() {
+		for (size_t block = nextBlock++; block < blockCount; block = nextBlock++)
+		{
+			action(block);
+		}
+	};
+
+	std::vector<std::jthread> threads;
+	for (unsigned thread = 1; thread < std::min<size_t>(threadCount, blockCount); thread++)
+	{
+		threads.emplace_back(worker);
+	}
+	worker();
+}
+
+// Быстрый путь для трёх знаков: |n| * 1000 округляется до целого с одной ошибкой округления умножения.
+// Если дробная часть произведения далека от 0.5, целое то же, что при точном округлении printf,
+// иначе решает std::to_chars
+bool TryFormatFixed3(double n, char*& pos)
+{
+	const double scaled = std::abs(n) * 1000;
+	if (!(scaled < 1e15))
+	{
+		return false;
+	}
+	const double whole = std::floor(scaled);
+	const double fraction = scaled - whole;
+	if (std::abs(fraction - 0.5) <= std::ldexp(scaled, -50))
+	{
+		return false;
+	}
+
+	const uint64_t value = static_cast<uint64_t>(whole) + (fraction > 0.5);
+	if (std::signbit(n))
+	{
+		*pos++ = '-';
+	}
+	pos = std::to_chars(pos, pos + 20, value / 1000).ptr;
+	const unsigned thousandths = static_cast<unsigned>(value % 1000);
+	pos[0] = '.';
+	pos[1] = static_cast<char>('0' + thousandths / 100);
+	pos[2] = static_cast<char>('0' + thousandths / 10 % 10);
+	pos[3] = static_cast<char>('0' + thousandths % 10);
+	pos += 4;
+	return true;
+}
+
+size_t GetBlockCount(size_t size)
+{
+	return (size + PARALLEL_SUM_BLOCK_SIZE - 1) / PARALLEL_SUM_BLOCK_SIZE;
+}
+
+template <typename T>
+std::span<T> GetBlock(std::span<T> nums, size_t block)
+{
+	const size_t begin = block * PARALLEL_SUM_BLOCK_SIZE;
+	return nums.subspan(begin, std::min(PARALLEL_SUM_BLOCK_SIZE, nums.size() - begin));
+}
+
+const unsigned RADIX_BITS = 11;
+const size_t RADIX_SIZE = size_t(1) << RADIX_BITS;
+const unsigned RADIX_PASSES = (64 + RADIX_BITS - 1) / RADIX_BITS;
+const uint64_t SIGN_BIT = uint64_t(1) << 63;
+
+// Ключи хранятся на месте чисел, поэтому читаются и пишутся побайтно через memcpy
+uint64_t LoadKey(const char* data)
+{
+	uint64_t key;
+	std::memcpy(&key, data, sizeof(key));
+	return key;
+}
 
+void StoreKey(char* data, uint64_t key)
+{
+	std::memcpy(data, &key, sizeof(key));
+}
+
+// Беззнаковый порядок ключей совпадает с порядком чисел:
+// у отрицательных инвертируются все биты, у остальных только знаковый
+uint64_t ToSortKey(uint64_t bits)
+{
+	return (bits & SIGN_BIT) ? ~bits : bits | SIGN_BIT;
+}
+
+uint64_t FromSortKey(uint64_t key)
+{
+	return (key & SIGN_BIT) ? key & ~SIGN_BIT : ~key;
+}
+
+// LSD-сортировка по 11 бит за проход с одним вспомогательным буфером.
+// Гистограммы всех разрядов строятся за один проход, разряды, одинаковые у всех ключей, пропускаются
+void RadixSort(std::span<double> nums)
+{
+	using Histogram = std::array<size_t, RADIX_SIZE>;
+	std::vector<Histogram> histograms(RADIX_PASSES);
+	char* data = reinterpret_cast<char*>(nums.data());
+	for (size_t i = 0; i < nums.size(); i++)
+	{
+		const uint64_t key = ToSortKey(LoadKey(data + i * sizeof(double)));
+		StoreKey(data + i * sizeof(double), key);
+		for (unsigned pass = 0; pass < RADIX_PASSES; pass++)
+		{
+			histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+		}
+	}
+
+	auto scratch = std::make_unique_for_overwrite<uint64_t[]>(nums.size());
+	char* from = data;
+	char* to = reinterpret_cast<char*>(scratch.get());
+	for (unsigned pass = 0; pass < RADIX_PASSES; pass++)
+	{
+		Histogram& offsets = histograms[pass];
+		const unsigned shift = pass * RADIX_BITS;
+		if (offsets[(LoadKey(from) >> shift) & (RADIX_SIZE - 1)] == nums.size())
+		{
+			continue;
+		}
+		size_t offset = 0;
+		for (size_t& count : offsets)
+		{
+			offset += std::exchange(count, offset);
+		}
+		for (size_t i = 0; i < nums.size(); i++)
+		{
+			const uint64_t key = LoadKey(from + i * sizeof(double));
+			StoreKey(to + offsets[(key >> shift) & (RADIX_SIZE - 1)]++ * sizeof(double), key);
+		}
+		std::swap(from, to);
+	}
+
+	if (from != data)
+	{
+		std::memcpy(data, from, nums.size() * sizeof(double));
+	}
+	for (size_t i = 0; i < nums.size(); i++)
+	{
+		StoreKey(data + i * sizeof(double), FromSortKey(LoadKey(data + i * sizeof(double))));
+	}
+}
+} // namespace
+
+std::vector<double> ParseNumbers(std::string_view text)
+{
+	std::vector<double> nums;
+	nums.reserve(EstimateNumberCount(text));
+	AppendNumbers(text, nums);
+	return nums;
+}
+
+std::vector<double> ReadNumbers(std::istream& in)
+{
+	const std::vector<char> text = ReadAll(in);
+
+	// Поток, на котором чтение уже сломалось, как и раньше, даёт ошибку
 	if (in.fail() && !in.eof())
 	{
 		throw std::runtime_error("Bad value");
 	}
-	return nums;
+	try
+	{
+		return ParseNumbers(std::string_view(text.data(), text.size()));
+	}
+	catch (const std::runtime_error&)
+	{
+		// Оставляем поток в том же состоянии, что и после неудачного in >> n
+		in.clear(std::ios::failbit);
+		throw;
+	}
+}
+
+std::vector<double> ReadNumbersFromFile(const std::string& fileName)
+{
+	MappedFile file(fileName);
+	return ParseNumbers(std::string_view(file.Data(), file.Size()));
+}
+
+NumberStreamReader::NumberStreamReader(std::istream& in)
+	: m_in(in)
+{
+}
+
+bool NumberStreamReader::ReadBlock(std::vector<double>& nums)
+{
+	if (m_finished)
+	{
+		return false;
+	}
+
+	m_text.resize(m_carry + NUMBER_STREAM_BLOCK_SIZE);
+	m_in.read(m_text.data() + m_carry, NUMBER_STREAM_BLOCK_SIZE);
+	const size_t size = m_carry + static_cast<size_t>(m_in.gcount());
+	if (!m_in)
+	{
+		m_finished = true;
+		AppendNumbers(std::string_view(m_text.data(), size), nums);
+		return true;
+	}
+
+	// Разбираем текст до последнего пробельного символа включительно: число через него не переходит,
+	// а ошибка перед ним не будет принята за конец ввода
+	size_t cut = size;
+	while (cut > 0 && !IsSpace(m_text[cut - 1]))
+	{
+		--cut;
+	}
+	AppendNumbers(std::string_view(m_text.data(), cut), nums);
+	m_carry = size - cut;
+	std::memmove(m_text.data(), m_text.data() + cut, m_carry);
+	return true;
+}
+
+PositiveSum SumPositive(std::span<const double> nums)
+{
+	PositiveSum result;
+	size_t i = 0;
+	// Четыре независимых накопителя, чтобы сложения не ждали друг друга
+#if defined(NUMBERS_AVX2)
+	__m256d sums[4] = { _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd() };
+	__m256i counts = _mm256_setzero_si256();
+	for (; i + 16 <= nums.size(); i += 16)
+	{
+		for (int k = 0; k < 4; k++)
+		{
+			const __m256d values = _mm256_loadu_pd(nums.data() + i + 4 * k);
+			const __m256d positive = _mm256_cmp_pd(values, _mm256_setzero_pd(), _CMP_GT_OQ);
+			sums[k] = _mm256_add_pd(sums[k], _mm256_and_pd(values, positive));
+			// Маска положительного элемента равна -1
+			counts = _mm256_sub_epi64(counts, _mm256_castpd_si256(positive));
+		}
+	}
+	alignas(32) double sumLanes[4];
+	alignas(32) uint64_t countLanes[4];
+	_mm256_store_pd(sumLanes, _mm256_add_pd(_mm256_add_pd(sums[0], sums[1]), _mm256_add_pd(sums[2], sums[3])));
+	_mm256_store_si256(reinterpret_cast<__m256i*>(countLanes), counts);
+	result.sum = (sumLanes[0] + sumLanes[1]) + (sumLanes[2] + sumLanes[3]);
+	result.count = countLanes[0] + countLanes[1] + countLanes[2] + countLanes[3];
+#elif defined(NUMBERS_SSE2)
+	__m128d sums[4] = { _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd() };
+	__m128i counts = _mm_setzero_si128();
+	for (; i + 8 <= nums.size(); i += 8)
+	{
+		for (int k = 0; k < 4; k++)
+		{
+			const __m128d values = _mm_loadu_pd(nums.data() + i + 2 * k);
+			const __m128d positive = _mm_cmpgt_pd(values, _mm_setzero_pd());
+			sums[k] = _mm_add_pd(sums[k], _mm_and_pd(values, positive));
+			counts = _mm_sub_epi64(counts, _mm_castpd_si128(positive));
+		}
+	}
+	alignas(16) double sumLanes[2];
+	alignas(16) uint64_t countLanes[2];
+	_mm_store_pd(sumLanes, _mm_add_pd(_mm_add_pd(sums[0], sums[1]), _mm_add_pd(sums[2], sums[3])));
+	_mm_store_si128(reinterpret_cast<__m128i*>(countLanes), counts);
+	result.sum = sumLanes[0] + sumLanes[1];
+	result.count = countLanes[0] + countLanes[1];
+#else
+	double sums[4] = {};
+	for (; i + 4 <= nums.size(); i += 4)
+	{
+		for (int k = 0; k < 4; k++)
+		{
+			const bool positive = nums[i + k] > 0;
+			sums[k] += positive ? nums[i + k] : 0.0;
+			result.count += positive;
+		}
+	}
+	result.sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+#endif
+	for (; i < nums.size(); i++)
+	{
+		if (nums[i] > 0)
+		{
+			result.sum += nums[i];
+			result.count++;
+		}
+	}
+	return result;
 }
 
 std::vector<double> ProcessNumbers(const std::vector<double>& nums)
 {
-	std::vector<double> newNums;
-	double sumPositive = std::accumulate(nums.begin(), nums.end(), 0.0,
-		[](double acc, double n) { return n > 0 ? acc + n : acc; });
+	return ProcessNumbers(std::vector<double>(nums));
+}
+
+std::vector<double> ProcessNumbers(std::span<const double> nums)
+{
+	return ProcessNumbers(std::vector<double>(nums.begin(), nums.end()));
+}
+
+std::vector<double> ProcessNumbers(std::vector<double>&& nums)
+{
+	const PositiveSum positive = SumPositive(nums);
+	if (positive.count == 0) return std::move(nums);
 
-	int countPositive = std::count_if(nums.begin(), nums.end(), [](double n) { return n > 0; });
+	AddToAll(nums, nums, positive.sum / static_cast<double>(positive.count));
+	return std::move(nums);
+}
 
-	if (countPositive == 0) return nums;
+void PairwiseAccumulator::Add(double value)
+{
+	Partial partial{ value, 1 };
+	while (!m_partials.empty() && m_partials.back().size == partial.size)
+	{
+		partial = { m_partials.back().sum + partial.sum, 2 * partial.size };
+		m_partials.pop_back();
+	}
+	m_partials.push_back(partial);
+}
 
-	double avg = sumPositive / countPositive;
+double PairwiseAccumulator::Sum() const
+{
+	if (m_partials.empty())
+	{
+		return 0.0;
+	}
+	double sum = m_partials.back().sum;
+	for (size_t i = m_partials.size() - 1; i-- > 0;)
+	{
+		sum = m_partials[i].sum + sum;
+	}
+	return sum;
+}
 
-	for (double n : nums)
+double PairwiseSum(std::span<const double> values)
+{
+	PairwiseAccumulator accumulator;
+	for (double value : values)
+	{
+		accumulator.Add(value);
+	}
+	return accumulator.Sum();
+}
+
+void PositiveSumAccumulator::Add(std::span<const double> nums)
+{
+	while (!nums.empty())
+	{
+		// Целые блоки суммируются прямо из переданного массива
+		if (m_block.empty() && nums.size() >= PARALLEL_SUM_BLOCK_SIZE)
+		{
+			AddBlock(nums.first(PARALLEL_SUM_BLOCK_SIZE));
+			nums = nums.subspan(PARALLEL_SUM_BLOCK_SIZE);
+			continue;
+		}
+		const size_t size = std::min(PARALLEL_SUM_BLOCK_SIZE - m_block.size(), nums.size());
+		m_block.insert(m_block.end(), nums.begin(), nums.begin() + size);
+		nums = nums.subspan(size);
+		if (m_block.size() == PARALLEL_SUM_BLOCK_SIZE)
+		{
+			AddBlock(m_block);
+			m_block.clear();
+		}
+	}
+}
+
+PositiveSum PositiveSumAccumulator::Result() const
+{
+	PairwiseAccumulator sums = m_sums;
+	PositiveSum result{ 0.0, m_count };
+	if (!m_block.empty())
 	{
-		newNums.push_back(n + avg);
+		PositiveSum block = SumPositive(m_block);
+		sums.Add(block.sum);
+		result.count += block.count;
 	}
-	return newNums;
+	result.sum = sums.Sum();
+	return result;
+}
+
+void PositiveSumAccumulator::AddBlock(std::span<const double> block)
+{
+	PositiveSum sum = SumPositive(block);
+	m_sums.Add(sum.sum);
+	m_count += sum.count;
+}
+
+PositiveSum SumPositiveParallel(std::span<const double> nums, unsigned threadCount)
+{
+	const size_t blockCount = GetBlockCount(nums.size());
+	std::vector<double> sums(blockCount);
+	std::vector<size_t> counts(blockCount);
+	ForEachBlock(blockCount, threadCount, [&](size_t block) {
+		PositiveSum sum = SumPositive(GetBlock(nums, block));
+		sums[block] = sum.sum;
+		counts[block] = sum.count;
+	});
+
+	PositiveSum result;
+	result.sum = PairwiseSum(sums);
+	for (size_t count : counts)
+	{
+		result.count += count;
+	}
+	return result;
+}
+
+NumberShift::NumberShift(const PositiveSum& positive)
+	: m_hasPositive(positive.count != 0)
+	, m_avg(m_hasPositive ? positive.sum / static_cast<double>(positive.count) : 0.0)
+{
+}
+
+std::vector<double> ProcessNumbersParallel(std::vector<double>&& nums, unsigned threadCount)
+{
+	const PositiveSum positive = SumPositiveParallel(nums, threadCount);
+	if (positive.count == 0) return std::move(nums);
+
+	const double avg = positive.sum / static_cast<double>(positive.count);
+	ForEachBlock(GetBlockCount(nums.size()), threadCount, [&](size_t block) {
+		std::span<double> numsBlock = GetBlock(std::span<double>(nums), block);
+		AddToAll(numsBlock, numsBlock, avg);
+	});
+	return std::move(nums);
+}
+
+std::vector<double> ProcessNumbersParallelCopy(std::span<const double> nums, unsigned threadCount)
+{
+	const PositiveSum positive = SumPositiveParallel(nums, threadCount);
+	if (positive.count == 0) return std::vector<double>(nums.begin(), nums.end());
+
+	// Копирование совмещено с прибавлением среднего
+	const double avg = positive.sum / static_cast<double>(positive.count);
+	std::vector<double> result(nums.size());
+	ForEachBlock(GetBlockCount(nums.size()), threadCount, [&](size_t block) {
+		AddToAll(GetBlock(nums, block), GetBlock(std::span<double>(result), block), avg);
+	});
+	return result;
+}
+
+bool IsNumberLess(double a, double b)
+{
+	return a < b || (a == b && std::signbit(a) && !std::signbit(b));
+}
+
+void SortNumbers(std::span<double> nums)
+{
+	if (nums.size() < RADIX_SORT_THRESHOLD)
+	{
+		std::sort(nums.begin(), nums.end(), IsNumberLess);
+		return;
+	}
+	RadixSort(nums);
+}
+
+SortedNumberWriter::SortedNumberWriter(std::ostream& out)
+	: m_out(out)
+{
+}
+
+void SortedNumberWriter::Write(double n)
+{
+	char* const begin = m_out.Reserve(MAX_FIXED_NUMBER_LENGTH);
+	char* pos = begin;
+	if (!m_first)
+	{
+		*pos++ = ' ';
+	}
+	m_first = false;
+	if (!TryFormatFixed3(n, pos))
+	{
+		// to_chars с точностью форматирует как printf("%.3f"), то есть так же, как std::fixed и setprecision(3)
+		pos = std::to_chars(pos, begin + MAX_FIXED_NUMBER_LENGTH, n, std::chars_format::fixed, 3).ptr;
+	}
+	m_out.Commit(pos);
+}
+
+void SortedNumberWriter::Finish()
+{
+	m_out.Put('\n');
+	m_out.Flush();
 }
 
 void PrintSortedNumbers(const std::vector<double>& nums, std::ostream& out)
 {
-	std::vector<double> sorted = nums;
-	std::sort(sorted.begin(), sorted.end());
+	PrintSortedNumbers(std::span<const double>(nums), out);
+}
 
-	out << std::fixed << std::setprecision(3);
-	for (size_t i = 0; i < sorted.size(); ++i)
+void PrintSortedNumbers(std::span<const double> nums, std::ostream& out)
+{
+	std::vector<double> sorted(nums.begin(), nums.end());
+	SortNumbers(sorted);
+
+	SortedNumberWriter writer(out);
+	for (double n : sorted)
 	{
-		if (i) out << " ";
-		out << sorted[i];
+		writer.Write(n);
 	}
-	out << std::endl;
-}
\ No newline at end of file
+	writer.Finish();
+}
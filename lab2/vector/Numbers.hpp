@@ -1,7 +1,11 @@
 #pragma once
 
+#include "BufferedIO.hpp"
+#include <cstddef>
 #include <iostream>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // - Функция ReadNumbers, которая считывает числа в vector.
@@ -9,8 +13,151 @@
 // - Функция PrintSortedNumbers, которая выводит переданный ей вектор в порядке неубывания.
 // Эта функция не должна модифицировать переданный ей vector видимым для вызывающего кода образом.
 
+// Разбирает числа через std::from_chars так же, как их прочитал бы цикл in >> n:
+// недописанное число в конце текста отбрасывается, иначе ошибка "Bad value"
+std::vector<double> ParseNumbers(std::string_view text);
+
+// Читает поток целиком большими блоками и разбирает его через ParseNumbers
 std::vector<double> ReadNumbers(std::istream& in);
 
+// Отображает файл в память и разбирает его без промежуточного копирования
+std::vector<double> ReadNumbersFromFile(const std::string& fileName);
+
+const size_t NUMBER_STREAM_BLOCK_SIZE = 1 << 20;
+
+// Читает числа из потока блоками по NUMBER_STREAM_BLOCK_SIZE байт, не держа в памяти весь текст.
+// Числа получаются те же, что и у ParseNumbers на всём тексте
+class NumberStreamReader
+{
+public:
+	explicit NumberStreamReader(std::istream& in);
+
+	// Дописывает в nums числа из очередного блока. false, когда поток уже прочитан до конца
+	bool ReadBlock(std::vector<double>& nums);
+
+private:
+	std::istream& m_in;
+	// Начало последнего числа, которое могло не поместиться в блок, переносится в следующий
+	std::string m_text;
+	size_t m_carry = 0;
+	bool m_finished = false;
+};
+
+struct PositiveSum
+{
+	double sum = 0;
+	size_t count = 0;
+};
+
+// Сумма и количество положительных элементов за один проход (AVX2 или SSE2, если доступны).
+// Сумма копится в нескольких независимых накопителях, поэтому отличается от последовательного
+// сложения. Каждая из двух сумм отстоит от точной не больше чем на n * 2^-53 * (сумма положительных),
+// так что друг от друга они отличаются не больше чем на 2 * n * 2^-53 * (сумма положительных)
+PositiveSum SumPositive(std::span<const double> nums);
+
+// Прибавляет к каждому элементу среднее арифметическое положительных элементов
 std::vector<double> ProcessNumbers(const std::vector<double>& nums);
 
-void PrintSortedNumbers(const std::vector<double>& nums, std::ostream& out);
\ No newline at end of file
+// То же для чисел, которые лежат не в векторе, например в отображённом файле
+std::vector<double> ProcessNumbers(std::span<const double> nums);
+
+// То же, но изменяет переданный вектор на месте, не копируя его
+std::vector<double> ProcessNumbers(std::vector<double>&& nums);
+
+const size_t PARALLEL_SUM_BLOCK_SIZE = 1 << 16;
+
+// Суммы блоков по PARALLEL_SUM_BLOCK_SIZE элементов считаются на threadCount потоках и складываются
+// попарно в порядке блоков, поэтому результат не зависит от числа потоков.
+// Вектор не длиннее одного блока суммируется так же, как SumPositive
+PositiveSum SumPositiveParallel(std::span<const double> nums, unsigned threadCount);
+
+// Попарное суммирование потока слагаемых: суммы групп по 2^i слагаемых хранятся, как разряды
+// двоичного счётчика, поэтому память O(log n), а порядок сложений зависит только от их количества
+class PairwiseAccumulator
+{
+public:
+	void Add(double value);
+	double Sum() const;
+
+private:
+	struct Partial
+	{
+		double sum;
+		size_t size;
+	};
+
+	std::vector<Partial> m_partials;
+};
+
+// Попарная сумма в порядке элементов через PairwiseAccumulator, ею SumPositiveParallel складывает суммы блоков
+double PairwiseSum(std::span<const double> values);
+
+// SumPositiveParallel для чисел, поступающих частями: память не зависит от их количества,
+// а результат совпадает с SumPositiveParallel на всём наборе
+class PositiveSumAccumulator
+{
+public:
+	void Add(std::span<const double> nums);
+	PositiveSum Result() const;
+
+private:
+	void AddBlock(std::span<const double> block);
+
+	std::vector<double> m_block;
+	PairwiseAccumulator m_sums;
+	size_t m_count = 0;
+};
+
+// Прибавление среднего положительных, как в ProcessNumbers, к числам, которые обрабатываются
+// не вектором: без положительных чисел значения не меняются
+class NumberShift
+{
+public:
+	explicit NumberShift(const PositiveSum& positive);
+
+	double operator()(double n) const { return m_hasPositive ? n + m_avg : n; }
+
+private:
+	bool m_hasPositive;
+	double m_avg;
+};
+
+// ProcessNumbers на threadCount потоках со средним из SumPositiveParallel
+std::vector<double> ProcessNumbersParallel(std::vector<double>&& nums, unsigned threadCount);
+
+// ProcessNumbersParallel, который пишет результат в новый вектор, совмещая копирование с прибавлением.
+// Отдельное имя, чтобы вызовы вида ProcessNumbersParallel({}, n) не стали неоднозначными
+std::vector<double> ProcessNumbersParallelCopy(std::span<const double> nums, unsigned threadCount);
+
+const size_t RADIX_SORT_THRESHOLD = 1 << 11;
+
+// Упорядочивает по неубыванию: короткие массивы через std::sort, длинные поразрядной сортировкой
+// по битам IEEE-754. В отличие от std::sort, -0 всегда стоит перед +0
+void SortNumbers(std::span<double> nums);
+
+// Порядок SortNumbers: как operator<, но -0 меньше +0
+bool IsNumberLess(double a, double b);
+
+// Выводит числа через пробел с тремя знаками после точки побайтно так же, как std::fixed и setprecision(3),
+// но без потока: через BufferedWriter, который сбрасывает вывод в out большими блоками
+class SortedNumberWriter
+{
+public:
+	explicit SortedNumberWriter(std::ostream& out);
+
+	void Write(double n);
+
+	// Завершает строку и сбрасывает вывод, как std::endl
+	void Finish();
+
+private:
+	// Пробел, знак, 309 цифр целой части DBL_MAX, точка и три знака
+	static constexpr size_t MAX_FIXED_NUMBER_LENGTH = 320;
+
+	BufferedWriter m_out;
+	bool m_first = true;
+};
+
+void PrintSortedNumbers(const std::vector<double>& nums, std::ostream& out);
+
+void PrintSortedNumbers(std::span<const double> nums, std::ostream& out);
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "Numbers.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+const std::string HELP_TEXT_BENCH = "Usage: vec-bench [<count> [<max threads>]]\n"
+									"Measures ProcessNumbersParallel on <count> random doubles with 1..<max threads> threads\n"
+									"and checks that every thread count gives bit-identical results.\n"
+									"Then compares SortNumbers (radix sort above RADIX_SORT_THRESHOLD) with std::sort.\n";
+
+const size_t DEFAULT_NUMBER_COUNT = 100'000'000;
+
+double MeasureMilliseconds(const std::function<void()>& action)
+{
+	auto start = std::chrono::steady_clock::now();
+	action();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+std::vector<double> GenerateNumbers(size_t count)
+{
+	std::mt19937_64 random(42);
+	std::uniform_real_distribution<double> value(-1000.0, 1000.0);
+	std::vector<double> nums(count);
+	for (double& n : nums)
+	{
+		n = value(random);
+	}
+	return nums;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t count = DEFAULT_NUMBER_COUNT;
+	unsigned maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	try
+	{
+		if (argc > 3)
+		{
+			throw std::invalid_argument("too many arguments");
+		}
+		if (argc > 1)
+		{
+			count = std::stoul(argv[1]);
+		}
+		if (argc > 2)
+		{
+			maxThreads = static_cast<unsigned>(std::max(std::stoul(argv[2]), 1ul));
+		}
+	}
+	catch (const std::exception&)
+	{
+		std::cout << HELP_TEXT_BENCH;
+		return 1;
+	}
+
+	const std::vector<double> source = GenerateNumbers(count);
+	std::vector<double> nums;
+	std::vector<double> expected;
+	double serialTime = 0;
+
+	std::cout << std::fixed << std::setprecision(1);
+	for (unsigned threadCount = 1; threadCount <= maxThreads; threadCount++)
+	{
+		nums = source;
+		const double time = MeasureMilliseconds([&]() { nums = ProcessNumbersParallel(std::move(nums), threadCount); });
+		if (threadCount == 1)
+		{
+			serialTime = time;
+			expected = nums;
+		}
+		else if (std::memcmp(nums.data(), expected.data(), nums.size() * sizeof(double)) != 0)
+		{
+			std::cout << threadCount << " threads: result differs from 1 thread" << std::endl;
+			return 1;
+		}
+		std::cout << threadCount << " threads: " << time << " ms, " << count * sizeof(double) / 1e3 / time
+				  << " MB/s, speedup " << std::setprecision(2) << serialTime / time << std::setprecision(1) << std::endl;
+	}
+
+	std::vector<double> sorted = source;
+	const double stdSortTime = MeasureMilliseconds([&]() { std::sort(sorted.begin(), sorted.end()); });
+	nums = source;
+	const double sortTime = MeasureMilliseconds([&]() { SortNumbers(nums); });
+	if (nums != sorted)
+	{
+		std::cout << "SortNumbers: result differs from std::sort" << std::endl;
+		return 1;
+	}
+	std::cout << "std::sort:   " << stdSortTime * 1e6 / count << " ns/number" << std::endl;
+	std::cout << "SortNumbers: " << sortTime * 1e6 / count << " ns/number" << std::endl;
+	return 0;
+}
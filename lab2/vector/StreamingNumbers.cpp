@@ -0,0 +1,172 @@
+#include "StreamingNumbers.hpp"
+#include "Numbers.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace
+{
+struct NumberGreater
+{
+	bool operator()(double a, double b) const { return IsNumberLess(b, a); }
+};
+
+// Скетч уровней: на уровне i лежат отсортированные выборки с весом 2^i. Заполненный уровень
+// сортируется, и каждое второе число (по очереди с чётного и нечётного места) поднимается на уровень выше
+class QuantileSketch
+{
+public:
+	explicit QuantileSketch(size_t levelSize)
+		: m_levelSize(std::max<size_t>(levelSize, 2))
+	{
+	}
+
+	void Add(double n)
+	{
+		if (m_levels.empty())
+		{
+			m_levels.emplace_back();
+		}
+		m_levels[0].push_back(n);
+		m_min = (m_count == 0 || IsNumberLess(n, m_min)) ? n : m_min;
+		m_max = (m_count == 0 || IsNumberLess(m_max, n)) ? n : m_max;
+		for (size_t level = 0; level < m_levels.size() && m_levels[level].size() > m_levelSize; level++)
+		{
+			Compact(level);
+		}
+		m_count++;
+	}
+
+	size_t Count() const { return m_count; }
+
+	// Число нижнего ранга floor(q * (n - 1)) для q = 0, 1/quantileCount, ..., 1
+	std::vector<double> GetQuantiles(size_t quantileCount) const
+	{
+		std::vector<std::pair<double, uint64_t>> weighted;
+		for (size_t level = 0; level < m_levels.size(); level++)
+		{
+			for (double n : m_levels[level])
+			{
+				weighted.emplace_back(n, uint64_t(1) << level);
+			}
+		}
+		std::sort(weighted.begin(), weighted.end(), [](const auto& a, const auto& b) { return IsNumberLess(a.first, b.first); });
+
+		std::vector<double> quantiles;
+		uint64_t weightBefore = 0;
+		size_t item = 0;
+		for (size_t q = 0; q <= quantileCount && !weighted.empty(); q++)
+		{
+			// floor((n - 1) * q / quantileCount) без переполнения произведения
+			const uint64_t rank = (m_count - 1) / quantileCount * q + (m_count - 1) % quantileCount * q / quantileCount;
+			while (item + 1 < weighted.size() && weightBefore + weighted[item].second <= rank)
+			{
+				weightBefore += weighted[item++].second;
+			}
+			quantiles.push_back(weighted[item].first);
+		}
+		// Крайние числа могли уйти при сжатии, но их помним точно
+		if (!quantiles.empty())
+		{
+			quantiles.front() = m_min;
+			quantiles.back() = m_max;
+		}
+		return quantiles;
+	}
+
+private:
+	void Compact(size_t level)
+	{
+		if (level + 1 == m_levels.size())
+		{
+			m_levels.emplace_back();
+			m_offsets.resize(m_levels.size());
+		}
+		std::vector<double>& items = m_levels[level];
+		std::sort(items.begin(), items.end(), IsNumberLess);
+		// Чередование смещения не даёт ошибкам округления ранга копиться в одну сторону
+		for (size_t i = m_offsets[level]; i < items.size(); i += 2)
+		{
+			m_levels[level + 1].push_back(items[i]);
+		}
+		m_offsets[level] ^= 1;
+		items.clear();
+	}
+
+	size_t m_levelSize;
+	std::vector<std::vector<double>> m_levels;
+	std::vector<size_t> m_offsets = std::vector<size_t>(1);
+	size_t m_count = 0;
+	double m_min = 0;
+	double m_max = 0;
+};
+} // namespace
+
+void PrintTopNumbers(std::istream& in, std::ostream& out, size_t count)
+{
+	NumberStreamReader reader(in);
+	PositiveSumAccumulator positive;
+	// Вершина кучи - наименьшее из отобранных чисел
+	std::priority_queue<double, std::vector<double>, NumberGreater> top;
+	std::vector<double> nums;
+	while (reader.ReadBlock(nums))
+	{
+		positive.Add(nums);
+		for (double n : nums)
+		{
+			if (top.size() < count)
+			{
+				top.push(n);
+			}
+			else if (count != 0 && IsNumberLess(top.top(), n))
+			{
+				top.pop();
+				top.push(n);
+			}
+		}
+		nums.clear();
+	}
+
+	std::vector<double> sorted;
+	sorted.reserve(top.size());
+	for (; !top.empty(); top.pop())
+	{
+		sorted.push_back(top.top());
+	}
+
+	// Прибавление среднего не меняет порядок, поэтому отбирать можно исходные числа
+	const NumberShift shift(positive.Result());
+	SortedNumberWriter writer(out);
+	for (double n : sorted)
+	{
+		writer.Write(shift(n));
+	}
+	writer.Finish();
+}
+
+void PrintNumberQuantiles(std::istream& in, std::ostream& out, size_t quantileCount, size_t sketchSize)
+{
+	NumberStreamReader reader(in);
+	PositiveSumAccumulator positive;
+	QuantileSketch sketch(sketchSize);
+	std::vector<double> nums;
+	while (reader.ReadBlock(nums))
+	{
+		positive.Add(nums);
+		for (double n : nums)
+		{
+			sketch.Add(n);
+		}
+		nums.clear();
+	}
+
+	const NumberShift shift(positive.Result());
+	SortedNumberWriter writer(out);
+	for (double n : sketch.GetQuantiles(std::max<size_t>(quantileCount, 1)))
+	{
+		writer.Write(shift(n));
+	}
+	writer.Finish();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+
+const size_t DEFAULT_QUANTILE_SKETCH_SIZE = 1 << 14;
+
+// Последние count чисел вывода PrintSortedNumbers(ProcessNumbers(ReadNumbers(in))) за один проход:
+// в памяти только куча из count наибольших чисел, среднее положительных считается на том же проходе
+void PrintTopNumbers(std::istream& in, std::ostream& out, size_t count);
+
+// Квантили 0, 1/quantileCount, ..., 1 обработанных чисел за один проход с памятью O(sketchSize * log n).
+// Пока чисел не больше sketchSize, квантили точные (нижний ранг floor(q * (n - 1))),
+// дальше ошибка ранга порядка n * log2(n / sketchSize) / sketchSize. Минимум и максимум всегда точные
+void PrintNumberQuantiles(std::istream& in, std::ostream& out, size_t quantileCount,
+	size_t sketchSize = DEFAULT_QUANTILE_SKETCH_SIZE);
@@ -1,8 +1,168 @@
+#include "ExternalSort.hpp"
+#include "NumberFile.hpp"
 #include "Numbers.hpp"
+#include "StreamingNumbers.hpp"
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 
-int main(int argc, char* argv[])
+struct Args
+{
+	std::optional<std::string> inputFileName;
+	unsigned threadCount = 0;
+	// Размер памяти для внешней сортировки в МиБ, 0 - всё в памяти
+	size_t externalMemory = 0;
+	std::optional<size_t> topCount;
+	std::optional<size_t> quantileCount;
+	// Вместо обработки сохранить числа в двоичном формате
+	std::optional<std::string> saveFileName;
+	NumberEncoding encoding = NumberEncoding::RAW;
+};
+
+std::optional<Args> ParseArgs(int argc, char* argv[])
+{
+	Args args;
+	int i = 1;
+	try
+	{
+		for (; i + 1 < argc && std::string(argv[i]).starts_with("--"); i += 2)
+		{
+			const std::string option = argv[i];
+			if (option == "--threads")
+			{
+				args.threadCount = static_cast<unsigned>(std::stoul(argv[i + 1]));
+			}
+			else if (option == "--external")
+			{
+				args.externalMemory = std::stoul(argv[i + 1]);
+			}
+			else if (option == "--top")
+			{
+				args.topCount = std::stoul(argv[i + 1]);
+			}
+			else if (option == "--quantiles")
+			{
+				args.quantileCount = std::stoul(argv[i + 1]);
+			}
+			else if (option == "--save")
+			{
+				args.saveFileName = argv[i + 1];
+			}
+			else if (option == "--encoding" && (std::string(argv[i + 1]) == "raw" || std::string(argv[i + 1]) == "xor"))
+			{
+				args.encoding = std::string(argv[i + 1]) == "raw" ? NumberEncoding::RAW : NumberEncoding::XOR;
+			}
+			else
+			{
+				return std::nullopt;
+			}
+		}
+	}
+	catch (const std::exception&)
+	{
+		return std::nullopt;
+	}
+	if (i + 1 == argc)
+	{
+		args.inputFileName = argv[i];
+	}
+	else if (i != argc)
+	{
+		return std::nullopt;
+	}
+	return args;
+}
+
+// Числа читаются из потока, не помещаясь в память целиком: внешняя сортировка, top-K или квантили
+void ProcessStream(const Args& args, std::istream& input)
+{
+	if (args.topCount)
+	{
+		PrintTopNumbers(input, std::cout, *args.topCount);
+	}
+	else if (args.quantileCount)
+	{
+		PrintNumberQuantiles(input, std::cout, *args.quantileCount);
+	}
+	else
+	{
+		ProcessNumbersExternal(input, std::cout, args.externalMemory << 20, std::filesystem::temp_directory_path());
+	}
+}
+
+void ProcessStream(const Args& args)
 {
-	auto nums = ReadNumbers(std::cin);
-	nums = ProcessNumbers(nums);
+	if (!args.inputFileName)
+	{
+		ProcessStream(args, std::cin);
+		return;
+	}
+	std::ifstream input(*args.inputFileName, std::ios::binary);
+	if (!input)
+	{
+		throw std::runtime_error("Can't open file " + *args.inputFileName);
+	}
+	ProcessStream(args, input);
+}
+
+// Двоичный файл отображается в память и обрабатывается без разбора текста
+void ProcessNumberFile(const Args& args, unsigned threadCount)
+{
+	NumberFile file(*args.inputFileName);
+	if (args.saveFileName)
+	{
+		WriteNumberFile(*args.saveFileName, file.Numbers(), args.encoding);
+		return;
+	}
+	if (args.externalMemory != 0 || args.topCount || args.quantileCount)
+	{
+		throw std::runtime_error("--external, --top and --quantiles need text input");
+	}
+	auto nums = ProcessNumbersParallelCopy(file.Numbers(), threadCount);
 	PrintSortedNumbers(nums, std::cout);
+}
+
+int main(int argc, char* argv[])
+{
+	std::ios::sync_with_stdio(false);
+
+	auto args = ParseArgs(argc, argv);
+	if (!args)
+	{
+		std::cerr << "Usage: vec [--threads <count>] [--external <memory MiB> | --top <count> | --quantiles <count>\n"
+					 "           | --save <binary file> [--encoding raw|xor]] [<input file>]\n";
+		return 1;
+	}
+	// Результат от числа потоков не зависит
+	const unsigned threadCount = args->threadCount != 0 ? args->threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+
+	try
+	{
+		if (args->inputFileName && IsNumberFile(*args->inputFileName))
+		{
+			ProcessNumberFile(*args, threadCount);
+			return 0;
+		}
+		if (args->externalMemory != 0 || args->topCount || args->quantileCount)
+		{
+			ProcessStream(*args);
+			return 0;
+		}
+		auto nums = args->inputFileName ? ReadNumbersFromFile(*args->inputFileName) : ReadNumbers(std::cin);
+		if (args->saveFileName)
+		{
+			WriteNumberFile(*args->saveFileName, nums, args->encoding);
+			return 0;
+		}
+		nums = ProcessNumbersParallel(std::move(nums), threadCount);
+		PrintSortedNumbers(nums, std::cout);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
 }
\ No newline at end of file
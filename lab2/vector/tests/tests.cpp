@@ -1,8 +1,19 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 
+#include "ExternalSort.hpp"
+#include "NumberFile.hpp"
 #include "Numbers.hpp"
-
+#include "StreamingNumbers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -42,6 +53,65 @@ TEST_CASE("ReadNumbers reads numbers from stream", "[ReadNumbers]")
 	}
 }
 
+TEST_CASE("ParseNumbers reads numbers like operator>>", "[ReadNumbers]")
+{
+	SECTION("Accepts signs, exponents and any whitespace")
+	{
+		std::vector<double> expected = { 5.0, -0.5, 1500.0, 0.25, 12.0, -3.0 };
+
+		REQUIRE(ParseNumbers("+5\t-.5\n1.5e3\r\n  25E-2 00012 -3.") == expected);
+	}
+
+	SECTION("Numbers need not be separated by spaces")
+	{
+		std::vector<double> expected = { 1.0, 0.2, 1.5, -2.0 };
+
+		REQUIRE(ParseNumbers("1..2 1.5-2") == expected);
+	}
+
+	SECTION("Rejects inf, nan, hex and overflow")
+	{
+		REQUIRE_THROWS_WITH(ParseNumbers("1 inf 2"), "Bad value");
+		REQUIRE_THROWS_WITH(ParseNumbers("nan"), "Bad value");
+		REQUIRE_THROWS_WITH(ParseNumbers("0x10"), "Bad value");
+		REQUIRE_THROWS_WITH(ParseNumbers("1e400 1"), "Bad value");
+		REQUIRE_THROWS_WITH(ParseNumbers("1e 2"), "Bad value");
+		REQUIRE_THROWS_WITH(ParseNumbers("+-5"), "Bad value");
+	}
+
+	SECTION("Underflow gives zero")
+	{
+		REQUIRE(ParseNumbers("1e-400") == std::vector<double>{ 0.0 });
+	}
+
+	SECTION("Unfinished number at the end is dropped")
+	{
+		std::vector<double> expected = { 1.0 };
+
+		REQUIRE(ParseNumbers("1 -") == expected);
+		REQUIRE(ParseNumbers("1 2e+") == expected);
+		REQUIRE(ParseNumbers("1 1e400") == expected);
+	}
+
+	SECTION("Matches the stream reader on large input")
+	{
+		std::string text;
+		std::vector<double> expected;
+		for (int i = 0; i < 100000; ++i)
+		{
+			double n = (i % 2 ? -1 : 1) * i * 0.37;
+			std::ostringstream number;
+			number.precision(17);
+			number << n;
+			text += number.str() + (i % 10 ? " " : "\n");
+			expected.push_back(n);
+		}
+		std::stringstream ss(text);
+
+		REQUIRE(ReadNumbers(ss) == expected);
+	}
+}
+
 TEST_CASE("ProcessNumbers adds average of positive elements", "[ProcessNumbers]")
 {
 	SECTION("Mixed positive and negative numbers")
@@ -118,6 +188,171 @@ TEST_CASE("ProcessNumbers adds average of positive elements", "[ProcessNumbers]"
 	}
 }
 
+TEST_CASE("SumPositive sums positive elements in one pass", "[ProcessNumbers]")
+{
+	SECTION("Counts every length around the vector block size")
+	{
+		for (size_t size = 0; size < 40; ++size)
+		{
+			std::vector<double> input;
+			for (size_t i = 0; i < size; ++i)
+			{
+				input.push_back(i % 3 == 0 ? -static_cast<double>(i) : static_cast<double>(i));
+			}
+			double expectedSum = 0;
+			size_t expectedCount = 0;
+			for (double n : input)
+			{
+				if (n > 0)
+				{
+					expectedSum += n;
+					expectedCount++;
+				}
+			}
+
+			PositiveSum result = SumPositive(input);
+			REQUIRE(result.sum == expectedSum);
+			REQUIRE(result.count == expectedCount);
+		}
+	}
+
+	SECTION("Skips zeros and NaN")
+	{
+		std::vector<double> input = { 0.0, -0.0, std::nan(""), 2.0, -1.0 };
+
+		PositiveSum result = SumPositive(input);
+		REQUIRE(result.sum == 2.0);
+		REQUIRE(result.count == 1);
+	}
+
+	SECTION("Matches sequential summation within the documented tolerance")
+	{
+		std::mt19937 random(42);
+		std::uniform_real_distribution<double> value(-1000.0, 1000.0);
+		std::vector<double> input(100003);
+		for (double& n : input)
+		{
+			n = value(random);
+		}
+		double expectedSum = 0;
+		for (double n : input)
+		{
+			expectedSum += n > 0 ? n : 0.0;
+		}
+
+		PositiveSum result = SumPositive(input);
+		REQUIRE(std::abs(result.sum - expectedSum) <= 2 * input.size() * std::ldexp(expectedSum, -53));
+	}
+}
+
+TEST_CASE("ProcessNumbers on rvalue changes the vector in place", "[ProcessNumbers]")
+{
+	std::vector<double> input = { 1.0, 2.0, 3.0, -4.0, -5.0 };
+	const double* data = input.data();
+	std::vector<double> expected = { 3.0, 4.0, 5.0, -2.0, -3.0 };
+
+	auto result = ProcessNumbers(std::move(input));
+	REQUIRE(result == expected);
+	REQUIRE(result.data() == data);
+}
+
+TEST_CASE("ProcessNumbersParallel does not depend on thread count", "[ProcessNumbers][parallel]")
+{
+	SECTION("Bit-identical results for any number of threads")
+	{
+		std::mt19937 random(43);
+		std::uniform_real_distribution<double> value(-1e6, 1e6);
+		std::vector<double> input(5 * PARALLEL_SUM_BLOCK_SIZE + 123);
+		for (double& n : input)
+		{
+			n = value(random);
+		}
+
+		PositiveSum expected = SumPositiveParallel(input, 1);
+		std::vector<double> expectedNums = ProcessNumbersParallel(std::vector<double>(input), 1);
+		for (unsigned threadCount : { 2, 3, 4, 16 })
+		{
+			PositiveSum result = SumPositiveParallel(input, threadCount);
+			REQUIRE(std::memcmp(&result.sum, &expected.sum, sizeof(double)) == 0);
+			REQUIRE(result.count == expected.count);
+			REQUIRE(ProcessNumbersParallel(std::vector<double>(input), threadCount) == expectedNums);
+		}
+	}
+
+	SECTION("Matches ProcessNumbers on vectors within one block")
+	{
+		std::vector<double> input = { 0.1, 0.2, -0.3, 0.7, 1e10, -5.0 };
+
+		REQUIRE(ProcessNumbersParallel(std::vector<double>(input), 4) == ProcessNumbers(input));
+		REQUIRE(ProcessNumbersParallel({}, 4).empty());
+		REQUIRE(ProcessNumbersParallel({ -1.0 }, 4) == std::vector<double>{ -1.0 });
+	}
+}
+
+TEST_CASE("SortNumbers sorts like std::sort", "[SortNumbers]")
+{
+	SECTION("Short and long arrays of mixed values")
+	{
+		std::mt19937 random(44);
+		std::uniform_real_distribution<double> value(-1e3, 1e3);
+		const std::vector<size_t> sizes = { 0, 1, 5, RADIX_SORT_THRESHOLD - 1, RADIX_SORT_THRESHOLD, 100000 };
+		for (size_t size : sizes)
+		{
+			std::vector<double> nums(size);
+			for (double& n : nums)
+			{
+				n = value(random);
+			}
+			std::vector<double> expected = nums;
+			std::sort(expected.begin(), expected.end());
+
+			SortNumbers(nums);
+			REQUIRE(nums == expected);
+		}
+	}
+
+	SECTION("Extreme values, duplicates and signed zeros")
+	{
+		const std::vector<double> values = { -std::numeric_limits<double>::infinity(), -1e308, -1.0, -5e-324, -0.0, 0.0,
+			5e-324, 1.0, 1.0, 1e308, std::numeric_limits<double>::infinity() };
+		std::vector<double> nums;
+		for (size_t i = 0; i < RADIX_SORT_THRESHOLD; ++i)
+		{
+			nums.push_back(values[(i * 7) % values.size()]);
+		}
+		std::vector<double> expected = nums;
+		std::sort(expected.begin(), expected.end());
+
+		SortNumbers(nums);
+		REQUIRE(nums == expected);
+		auto firstZero = std::find(nums.begin(), nums.end(), 0.0);
+		REQUIRE(std::signbit(*firstZero));
+		REQUIRE(!std::signbit(*(std::find(nums.rbegin(), nums.rend(), 0.0))));
+
+		std::vector<double> small = { 0.0, -0.0, 1.0, -0.0, 0.0 };
+		SortNumbers(small);
+		REQUIRE(small == std::vector<double>{ -0.0, -0.0, 0.0, 0.0, 1.0 });
+		REQUIRE(std::signbit(small[0]));
+		REQUIRE(std::signbit(small[1]));
+		REQUIRE(!std::signbit(small[2]));
+		REQUIRE(!std::signbit(small[3]));
+	}
+
+	SECTION("Values with equal high bits")
+	{
+		std::vector<double> nums;
+		for (size_t i = 0; i < 5000; ++i)
+		{
+			nums.push_back(1.0 + static_cast<double>((i * 7919) % 5000) * 1e-12);
+		}
+		std::vector<double> expected = nums;
+		std::sort(expected.begin(), expected.end());
+
+		SortNumbers(nums);
+		REQUIRE(nums == expected);
+	}
+}
+
 TEST_CASE("PrintSortedNumbers prints sorted numbers with precision 3", "[PrintSortedNumbers]")
 {
 	SECTION("Prints sorted numbers")
@@ -175,4 +410,264 @@ TEST_CASE("PrintSortedNumbers prints sorted numbers with precision 3", "[PrintSo
 		std::string expected = "-5.000 -1.000 0.000 3.000\n";
 		REQUIRE(ss.str() == expected);
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("SortedNumberWriter formats like std::fixed with precision 3", "[PrintSortedNumbers]")
+{
+	auto formatWithStream = [](const std::vector<double>& nums) {
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(3);
+		for (size_t i = 0; i < nums.size(); ++i)
+		{
+			if (i) out << " ";
+			out << nums[i];
+		}
+		out << std::endl;
+		return out.str();
+	};
+	auto formatWithWriter = [](const std::vector<double>& nums) {
+		std::ostringstream out;
+		SortedNumberWriter writer(out);
+		for (double n : nums)
+		{
+			writer.Write(n);
+		}
+		writer.Finish();
+		return out.str();
+	};
+
+	SECTION("Signed zeros, ties and extreme values")
+	{
+		std::vector<double> nums = { -0.0, 0.0, -0.0004, 0.0005, 0.0015, 0.0025, -1.0005, 2.675, 999.9995, 1e15, 1e300,
+			-std::numeric_limits<double>::max(), 5e-324, std::numeric_limits<double>::infinity() };
+
+		REQUIRE(formatWithWriter(nums) == formatWithStream(nums));
+		REQUIRE(formatWithWriter({ -0.0, -0.0001 }) == "-0.000 -0.000\n");
+	}
+
+	SECTION("Every half-thousandth and its neighbours")
+	{
+		std::vector<double> nums;
+		for (int k = -20000; k <= 20000; ++k)
+		{
+			const double n = k / 2000.0;
+			nums.push_back(n);
+			nums.push_back(std::nextafter(n, 1e300));
+			nums.push_back(std::nextafter(n, -1e300));
+		}
+
+		REQUIRE(formatWithWriter(nums) == formatWithStream(nums));
+	}
+
+	SECTION("Output larger than the buffer")
+	{
+		std::vector<double> nums(300000, -123456.789);
+
+		REQUIRE(formatWithWriter(nums) == formatWithStream(nums));
+	}
+}
+
+TEST_CASE("ProcessNumbersExternal matches in-memory processing", "[ProcessNumbersExternal]")
+{
+	const auto tempDir = std::filesystem::temp_directory_path();
+	auto processInMemory = [](const std::string& text) {
+		std::stringstream in(text);
+		std::stringstream out;
+		PrintSortedNumbers(ProcessNumbersParallel(ReadNumbers(in), 1), out);
+		return out.str();
+	};
+	auto processExternal = [&](const std::string& text, size_t memoryLimit) {
+		std::stringstream in(text);
+		std::stringstream out;
+		ProcessNumbersExternal(in, out, memoryLimit, tempDir);
+		return out.str();
+	};
+
+	SECTION("Several runs are merged")
+	{
+		std::mt19937 random(45);
+		std::uniform_real_distribution<double> value(-1e4, 1e4);
+		std::ostringstream text;
+		text.precision(17);
+		for (size_t i = 0; i < 5 * PARALLEL_SUM_BLOCK_SIZE + 777; ++i)
+		{
+			text << value(random) << (i % 8 ? ' ' : '\n');
+		}
+		text << "-0 0 -0";
+
+		// Одна серия на блок суммы
+		REQUIRE(processExternal(text.str(), 2 * sizeof(double) * PARALLEL_SUM_BLOCK_SIZE) == processInMemory(text.str()));
+	}
+
+	SECTION("Small input is processed without runs")
+	{
+		REQUIRE(processExternal("1 2 3 -4 -5", 1 << 20) == "-3.000 -2.000 3.000 4.000 5.000\n");
+		REQUIRE(processExternal("-0 -1", 1 << 20) == "-1.000 -0.000\n");
+		REQUIRE(processExternal("", 1 << 20) == "\n");
+	}
+
+	SECTION("Bad value is reported")
+	{
+		std::string text(3 * NUMBER_STREAM_BLOCK_SIZE, ' ');
+		text += "1.5 abc";
+
+		REQUIRE_THROWS_WITH(processExternal(text, 1 << 20), "Bad value");
+	}
+}
+
+TEST_CASE("Streaming modes match the sorted output", "[StreamingNumbers]")
+{
+	std::mt19937 random(47);
+	std::uniform_real_distribution<double> value(-1e3, 1e3);
+	std::ostringstream text;
+	text.precision(17);
+	std::vector<double> nums;
+	for (size_t i = 0; i < 3 * PARALLEL_SUM_BLOCK_SIZE + 11; ++i)
+	{
+		nums.push_back(value(random));
+		text << nums.back() << ' ';
+	}
+	std::vector<double> processed = ProcessNumbersParallel(std::vector<double>(nums), 1);
+	SortNumbers(processed);
+
+	auto format = [](std::span<const double> values) {
+		std::ostringstream out;
+		SortedNumberWriter writer(out);
+		for (double n : values)
+		{
+			writer.Write(n);
+		}
+		writer.Finish();
+		return out.str();
+	};
+
+	SECTION("PositiveSumAccumulator matches SumPositiveParallel for any chunking")
+	{
+		PositiveSum expected = SumPositiveParallel(nums, 1);
+		for (size_t chunk : { size_t(1000), PARALLEL_SUM_BLOCK_SIZE, nums.size() })
+		{
+			PositiveSumAccumulator accumulator;
+			for (size_t begin = 0; begin < nums.size(); begin += chunk)
+			{
+				accumulator.Add(std::span<const double>(nums).subspan(begin, std::min(chunk, nums.size() - begin)));
+			}
+			PositiveSum result = accumulator.Result();
+			REQUIRE(std::memcmp(&result.sum, &expected.sum, sizeof(double)) == 0);
+			REQUIRE(result.count == expected.count);
+		}
+	}
+
+	SECTION("Top K is the tail of the sorted output")
+	{
+		for (size_t count : { size_t(0), size_t(1), size_t(1000), nums.size() + 5 })
+		{
+			std::stringstream in(text.str());
+			std::ostringstream out;
+			PrintTopNumbers(in, out, count);
+
+			const size_t tail = std::min(count, processed.size());
+			REQUIRE(out.str() == format(std::span<const double>(processed).last(tail)));
+		}
+	}
+
+	SECTION("Quantiles are exact while the sketch holds every number")
+	{
+		std::stringstream in(text.str());
+		std::ostringstream out;
+		PrintNumberQuantiles(in, out, 4, nums.size());
+
+		const size_t n = processed.size();
+		std::vector<double> expected = { processed[0], processed[(n - 1) / 4], processed[(n - 1) / 2], processed[3 * (n - 1) / 4],
+			processed[n - 1] };
+		REQUIRE(out.str() == format(expected));
+	}
+
+	SECTION("Sketched quantiles stay within the rank error bound")
+	{
+		const size_t sketchSize = 1024;
+		std::stringstream in(text.str());
+		std::ostringstream out;
+		PrintNumberQuantiles(in, out, 10, sketchSize);
+
+		std::istringstream result(out.str());
+		const double n = static_cast<double>(processed.size());
+		const double maxRankError = n * std::log2(n / sketchSize) / sketchSize;
+		for (int q = 0; q <= 10; ++q)
+		{
+			double quantile;
+			REQUIRE(result >> quantile);
+			const double rank = static_cast<double>(std::lower_bound(processed.begin(), processed.end(), quantile - 5e-4) - processed.begin());
+			REQUIRE(std::abs(rank - (n - 1) * q / 10) <= maxRankError);
+		}
+	}
+
+	SECTION("Empty input")
+	{
+		std::stringstream in("");
+		std::ostringstream top;
+		std::ostringstream quantiles;
+		PrintTopNumbers(in, top, 3);
+		in.clear();
+		PrintNumberQuantiles(in, quantiles, 3);
+
+		REQUIRE(top.str() == "\n");
+		REQUIRE(quantiles.str() == "\n");
+	}
+}
+
+TEST_CASE("Number files store doubles exactly", "[NumberFile]")
+{
+	const std::string fileName = (std::filesystem::temp_directory_path() / "vec-test-numbers.bin").string();
+	std::vector<double> nums = { -0.0, 0.0, 1.0, 1.0, 1.5, -2.25, 5e-324, 1e308, std::numeric_limits<double>::infinity(),
+		std::numeric_limits<double>::quiet_NaN() };
+	std::mt19937 random(48);
+	std::uniform_real_distribution<double> value(-1e3, 1e3);
+	for (size_t i = 0; i < 3 * XOR_BLOCK_SIZE + 5; ++i)
+	{
+		// Медленно меняющийся ряд с повторами, как в реальных выгрузках
+		nums.push_back(i % 7 == 0 ? nums.back() : std::round(value(random)) / 8);
+	}
+
+	for (NumberEncoding encoding : { NumberEncoding::RAW, NumberEncoding::XOR })
+	{
+		WriteNumberFile(fileName, nums, encoding);
+		REQUIRE(IsNumberFile(fileName));
+		{
+			NumberFile file(fileName);
+			REQUIRE(file.Numbers().size() == nums.size());
+			REQUIRE(std::memcmp(file.Numbers().data(), nums.data(), nums.size() * sizeof(double)) == 0);
+		}
+
+		WriteNumberFile(fileName, std::vector<double>(), encoding);
+		NumberFile empty(fileName);
+		REQUIRE(empty.Numbers().empty());
+	}
+
+	SECTION("Truncated and foreign files are rejected")
+	{
+		WriteNumberFile(fileName, nums, NumberEncoding::XOR);
+		std::filesystem::resize_file(fileName, std::filesystem::file_size(fileName) - 3);
+		REQUIRE_THROWS_AS(NumberFile(fileName), std::runtime_error);
+
+		std::ofstream(fileName) << "1 2 3";
+		REQUIRE(!IsNumberFile(fileName));
+		REQUIRE_THROWS_AS(NumberFile(fileName), std::runtime_error);
+	}
+
+	std::filesystem::remove(fileName);
+}
+
+TEST_CASE("Span overloads match vector ones", "[ProcessNumbers]")
+{
+	const std::vector<double> nums = { 3.5, -1.0, 0.0, 7.25, -0.0, 2.0 };
+	std::span<const double> span(nums);
+
+	REQUIRE(ProcessNumbers(span) == ProcessNumbers(nums));
+	REQUIRE(ProcessNumbersParallelCopy(span, 3) == ProcessNumbersParallel(std::vector<double>(nums), 3));
+
+	std::ostringstream fromSpan;
+	std::ostringstream fromVector;
+	PrintSortedNumbers(span, fromSpan);
+	PrintSortedNumbers(nums, fromVector);
+	REQUIRE(fromSpan.str() == fromVector.str());
+}